@@ -0,0 +1,78 @@
+// Counts heap allocations for the harness: global operator new, plus
+// cv::Mat buffers (OpenCV allocates those with its own fastMalloc).
+
+#include "harness.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <opencv2/core.hpp>
+
+namespace {
+
+std::atomic<int64_t> allocations{0};
+
+void* countedAlloc(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* countedAlignedAlloc(std::size_t size, std::align_val_t alignment) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    std::size_t align = static_cast<std::size_t>(alignment);
+    std::size_t rounded = (std::max<std::size_t>(size, 1) + align - 1) / align * align;
+    if (void* p = std::aligned_alloc(align, rounded)) return p;
+    throw std::bad_alloc();
+}
+
+// Forwards to OpenCV's default allocator, counting new pixel buffers
+class CountingMatAllocator : public cv::MatAllocator {
+public:
+    explicit CountingMatAllocator(cv::MatAllocator* base) : base(base) {}
+    
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                           cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override {
+        if (!data) allocations.fetch_add(1, std::memory_order_relaxed);
+        return base->allocate(dims, sizes, type, data, step, flags, usageFlags);
+    }
+    
+    bool allocate(cv::UMatData* data, cv::AccessFlag accessFlags,
+                  cv::UMatUsageFlags usageFlags) const override {
+        return base->allocate(data, accessFlags, usageFlags);
+    }
+    
+    void deallocate(cv::UMatData* data) const override {
+        base->deallocate(data);
+    }
+
+private:
+    cv::MatAllocator* base;
+};
+
+} // namespace
+
+namespace bench {
+
+int64_t allocationCount() {
+    static CountingMatAllocator matAllocator(cv::Mat::getStdAllocator());
+    static bool installed = (cv::Mat::setDefaultAllocator(&matAllocator), true);
+    (void)installed;
+    return allocations.load(std::memory_order_relaxed);
+}
+
+} // namespace bench
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return countedAlignedAlloc(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return countedAlignedAlloc(size, alignment); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
@@ -0,0 +1,102 @@
+// Epicycle evaluation: getEpicyclePositions (AoS, std::cos/sin) against the
+// SoA kernels and the phasor-recurrence evaluator.
+
+#include "harness.hpp"
+#include "synthetic_shapes.hpp"
+#include "fourier.hpp"
+#include "epicycle_kernel.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr int TOTAL_FRAMES = 600;
+
+double frameTime(int64_t frame) {
+    return bench::TWO_PI * static_cast<double>(frame % TOTAL_FRAMES) / TOTAL_FRAMES;
+}
+
+double maxDeviation(const std::vector<cv::Point2d>& a, const std::vector<cv::Point2d>& b) {
+    double deviation = 0.0;
+    for (size_t i = 0; i < a.size() && i < b.size(); ++i) {
+        deviation = std::max(deviation, std::hypot(a[i].x - b[i].x, a[i].y - b[i].y));
+    }
+    return deviation;
+}
+
+void BM_getEpicyclePositions(bench::State& state) {
+    auto coefficients = bench::makeCoefficients(static_cast<int>(state.range(0)));
+    std::vector<cv::Point2d> positions;
+    int64_t frame = 0;
+    while (state.keepRunning()) {
+        fourier::getEpicyclePositions(coefficients, frameTime(frame++), positions);
+        bench::doNotOptimize(positions.back());
+    }
+}
+FOURIER_BENCHMARK(BM_getEpicyclePositions)
+    ->argNames({"circles"})
+    ->argsProduct({{100, 1000, 10000}});
+
+// kernel: 1 = Scalar, 2 = AVX2, 3 = NEON, 4 = Table (KernelType values)
+void BM_evaluateEpicycles(bench::State& state) {
+    auto kernel = static_cast<fourier::KernelType>(state.range(0));
+    if (!fourier::isKernelSupported(kernel)) {
+        state.skipWithError(std::string(fourier::kernelName(kernel)) + " not supported");
+        return;
+    }
+    
+    auto coefficients = bench::makeCoefficients(static_cast<int>(state.range(1)));
+    auto soa = fourier::CoefficientSoA::fromCoefficients(coefficients);
+    std::vector<cv::Point2d> positions;
+    int64_t frame = 0;
+    while (state.keepRunning()) {
+        fourier::evaluateEpicycles(soa, frameTime(frame++), positions, kernel);
+        bench::doNotOptimize(positions.back());
+    }
+    
+    fourier::evaluateEpicycles(soa, frameTime(123), positions, kernel);
+    state.counters["max_error"] =
+        maxDeviation(positions, fourier::getEpicyclePositions(coefficients, frameTime(123)));
+    state.setLabel(fourier::kernelName(kernel));
+}
+FOURIER_BENCHMARK(BM_evaluateEpicycles)
+    ->argNames({"kernel", "circles"})
+    ->argsProduct({{static_cast<int64_t>(fourier::KernelType::Scalar),
+                    static_cast<int64_t>(fourier::KernelType::AVX2),
+                    static_cast<int64_t>(fourier::KernelType::NEON),
+                    static_cast<int64_t>(fourier::KernelType::Table)},
+                   {100, 1000, 10000, 50000}});
+
+void BM_phasorEvaluator(bench::State& state) {
+    auto coefficients = bench::makeCoefficients(static_cast<int>(state.range(0)));
+    fourier::EpicycleEvaluator evaluator(coefficients, TOTAL_FRAMES);
+    std::vector<cv::Point2d> positions;
+    int64_t frame = 0;
+    while (state.keepRunning()) {
+        evaluator.evaluate(static_cast<int>(frame++ % TOTAL_FRAMES), positions);
+        bench::doNotOptimize(positions.back());
+    }
+    
+    evaluator.evaluate(123, positions);
+    state.counters["max_error"] =
+        maxDeviation(positions, fourier::getEpicyclePositions(coefficients, frameTime(123)));
+}
+FOURIER_BENCHMARK(BM_phasorEvaluator)
+    ->argNames({"circles"})
+    ->argsProduct({{100, 1000, 10000}});
+
+// One inverse FFT for the whole path table (samples = frames * samples/frame)
+void BM_sampleTrajectory(bench::State& state) {
+    auto coefficients = bench::makeCoefficients(static_cast<int>(state.range(0)));
+    const int samples = static_cast<int>(state.range(1));
+    while (state.keepRunning()) {
+        auto trajectory = fourier::sampleTrajectory(coefficients, samples);
+        bench::doNotOptimize(trajectory.data());
+    }
+}
+FOURIER_BENCHMARK(BM_sampleTrajectory)
+    ->argNames({"circles", "samples"})
+    ->argsProduct({{100, 1000}, {TOTAL_FRAMES * 8, 3600 * 8}});
+
+} // namespace
@@ -0,0 +1,317 @@
+// Contour preprocessing, DFT and frame rendering (single and multi-contour)
+// on synthetic shapes.
+
+#include "harness.hpp"
+#include "synthetic_shapes.hpp"
+#include "contour_extractor.hpp"
+#include "shape_tracker.hpp"
+#include "fourier.hpp"
+#include "animation.hpp"
+#include "frame_sink.hpp"
+#include "coefficient_cache.hpp"
+
+#include <opencv2/imgcodecs.hpp>
+#include <algorithm>
+#include <filesystem>
+
+namespace {
+
+// Star filled into a 16:9 frame; reuse: one ContourExtractor for every
+// frame (0 = extractContour, which allocates its work images each call)
+void BM_extractContour(bench::State& state) {
+    const int height = static_cast<int>(state.range(0));
+    const bool reuse = state.range(1) != 0;
+    cv::Mat image(height, height * 16 / 9, CV_8UC3, cv::Scalar(0, 0, 0));
+    std::vector<std::vector<cv::Point>> star = {bench::makeStarContour(2000, 7, height * 0.4)};
+    cv::fillPoly(image, star, cv::Scalar(255, 255, 255));
+    
+    fourier::ContourExtractor extractor;
+    while (state.keepRunning()) {
+        auto result = reuse ? extractor.extract(image) : fourier::extractContour(image);
+        bench::doNotOptimize(result.complexPoints.data());
+    }
+}
+FOURIER_BENCHMARK(BM_extractContour)
+    ->argNames({"height", "reuse"})
+    ->argsProduct({{480, 1080}, {0, 1}});
+
+// Many small stars, as from a noisy photo; metric: ContourMetric value
+void BM_selectContours(bench::State& state) {
+    const int count = static_cast<int>(state.range(0));
+    const auto metric = static_cast<fourier::ContourMetric>(state.range(1));
+    std::vector<std::vector<cv::Point>> contours;
+    for (int i = 0; i < count; ++i) {
+        contours.push_back(bench::makeStarContour(64 + i % 200, 5 + i % 4, 10.0 + i % 50));
+    }
+    while (state.keepRunning()) {
+        auto ranked = fourier::selectContours(contours, metric, 1);
+        bench::doNotOptimize(ranked.data());
+    }
+}
+FOURIER_BENCHMARK(BM_selectContours)
+    ->argNames({"contours", "metric"})
+    ->argsProduct({{100, 5000},
+                   {static_cast<int64_t>(fourier::ContourMetric::ArcLength),
+                    static_cast<int64_t>(fourier::ContourMetric::Area)}});
+
+// Synthetic clip: a star drifting half a pixel per frame, held still every
+// other 30 frames. tracking: ShapeTracker reuse on (0 = stateless path)
+void BM_trackShape(bench::State& state) {
+    constexpr int CLIP_FRAMES = 120;
+    const int height = static_cast<int>(state.range(0));
+    const cv::Size size(height * 16 / 9, height);
+    auto star = bench::makeStarContour(2000, 7, height * 0.3);
+    
+    std::vector<cv::Mat> clip;
+    for (int i = 0; i < CLIP_FRAMES; ++i) {
+        int shift = (i / 30) % 2 == 0 ? i / 2 : 0;
+        std::vector<std::vector<cv::Point>> moved = {star};
+        for (auto& p : moved[0]) p += cv::Point(size.width / 4 + shift, height / 5);
+        cv::Mat frame(size, CV_8UC3, cv::Scalar(0, 0, 0));
+        cv::fillPoly(frame, moved, cv::Scalar(255, 255, 255));
+        clip.push_back(frame);
+    }
+    
+    fourier::TrackerConfig config;
+    config.enabled = state.range(1) != 0;
+    fourier::ShapeTracker tracker(config, fourier::ContourConfig(), 100);
+    int64_t frame = 0;
+    while (state.keepRunning()) {
+        auto update = tracker.update(clip[frame++ % CLIP_FRAMES]);
+        bench::doNotOptimize(update);
+    }
+    
+    auto stats = tracker.getStats();
+    state.counters["roi_ratio"] = static_cast<double>(stats.roiSearches) / std::max(stats.frames, 1);
+    state.counters["fft_ratio"] = static_cast<double>(stats.transforms) / std::max(stats.frames, 1);
+}
+FOURIER_BENCHMARK(BM_trackShape)
+    ->argNames({"height", "tracking"})
+    ->argsProduct({{480, 1080}, {0, 1}});
+
+void BM_sampleContour(bench::State& state) {
+    auto contour = bench::makeStarContour(static_cast<int>(state.range(0)));
+    const int samples = static_cast<int>(state.range(1));
+    while (state.keepRunning()) {
+        auto sampled = fourier::sampleContour(contour, samples);
+        bench::doNotOptimize(sampled.data());
+    }
+}
+FOURIER_BENCHMARK(BM_sampleContour)
+    ->argNames({"points", "samples"})
+    ->argsProduct({{1000, 10000, 100000}, {500, 4096}});
+
+void BM_contourToComplex(bench::State& state) {
+    auto contour = bench::makeStarContour(static_cast<int>(state.range(0)));
+    cv::Point2d centroid;
+    double scale = 0.0;
+    while (state.keepRunning()) {
+        auto points = fourier::contourToComplex(contour, centroid, scale);
+        bench::doNotOptimize(points.data());
+    }
+}
+FOURIER_BENCHMARK(BM_contourToComplex)
+    ->argNames({"points"})
+    ->argsProduct({{500, 4096, 65536}});
+
+// sizePolicy: FFTSizePolicy value; 997 and 4099 are prime
+void BM_computeDFT(bench::State& state) {
+    auto points = bench::makeComplexShape(static_cast<int>(state.range(0)));
+    const int circles = static_cast<int>(state.range(1));
+    fourier::DFTOptions options;
+    options.sizePolicy = static_cast<fourier::FFTSizePolicy>(state.range(2));
+    while (state.keepRunning()) {
+        auto coefficients = fourier::computeDFT(points, circles, options);
+        bench::doNotOptimize(coefficients.data());
+    }
+}
+FOURIER_BENCHMARK(BM_computeDFT)
+    ->argNames({"points", "circles", "sizePolicy"})
+    ->argsProduct({{500, 997, 4096, 4099}, {100, 1000},
+                   {static_cast<int64_t>(fourier::FFTSizePolicy::Exact),
+                    static_cast<int64_t>(fourier::FFTSizePolicy::NextSmooth)}});
+
+// shapes: contours sharing one circle budget, split by energy
+void BM_computeDFTs(bench::State& state) {
+    auto shapes = bench::makeComplexShapes(static_cast<int>(state.range(0)), 500);
+    const int circles = static_cast<int>(state.range(1));
+    std::vector<std::vector<fourier::FourierCoefficient>> chains;
+    while (state.keepRunning()) {
+        chains = fourier::computeDFTs(shapes, circles);
+        bench::doNotOptimize(chains.data());
+    }
+    
+    size_t smallest = chains.empty() ? 0 : chains[0].size();
+    for (const auto& chain : chains) {
+        smallest = std::min(smallest, chain.size());
+    }
+    state.counters["smallest_chain"] = static_cast<double>(smallest);
+}
+FOURIER_BENCHMARK(BM_computeDFTs)
+    ->argNames({"shapes", "circles"})
+    ->argsProduct({{1, 4, 16}, {100, 1000}});
+
+// shapes: full 500-sample spectra read back from a coefficient file (the
+// cache hit path, versus extraction plus BM_computeDFTs); half: float16 values
+void BM_loadCoefficients(bench::State& state) {
+    auto shapes = bench::makeComplexShapes(static_cast<int>(state.range(0)), 500);
+    const bool half = state.range(1) != 0;
+    const std::string path = (std::filesystem::temp_directory_path() / "fourier_bench.fcof").string();
+    if (!fourier::saveCoefficients(path, fourier::computeDFTs(shapes, 0), half)) {
+        state.skipWithError("cannot write coefficient file");
+        return;
+    }
+    
+    fourier::CoefficientChains chains;
+    while (state.keepRunning()) {
+        fourier::loadCoefficients(path, chains);
+        bench::doNotOptimize(chains.data());
+    }
+    
+    state.counters["file_bytes"] = static_cast<double>(std::filesystem::file_size(path));
+    std::filesystem::remove(path);
+}
+FOURIER_BENCHMARK(BM_loadCoefficients)
+    ->argNames({"shapes", "half"})
+    ->argsProduct({{1, 16}, {0, 1}});
+
+// backend: RenderBackend value (1 = OpenCV, 2 = Cairo); height: 16:9 frame;
+// dirty: refresh only changed rectangles (0 = copy the whole path layer)
+void BM_renderFrame(bench::State& state) {
+    auto backend = static_cast<fourier::RenderBackend>(state.range(0));
+#ifndef USE_CAIRO
+    if (backend == fourier::RenderBackend::Cairo) {
+        state.skipWithError("built without Cairo");
+        return;
+    }
+#endif
+
+    const int height = static_cast<int>(state.range(1));
+    fourier::AnimationConfig config;
+    config.backend = backend;
+    config.resolution = cv::Size(height * 16 / 9, height);
+    config.center = cv::Point2d(config.resolution.width / 2.0, height / 2.0);
+    config.scale = height * 0.37;
+    config.showPath = state.range(2) != 0;
+    config.numCircles = static_cast<int>(state.range(3));
+    config.dirtyRectangles = state.range(4) != 0;
+    
+    fourier::AnimationEngine engine;
+    engine.initialize(bench::makeCoefficients(config.numCircles), config);
+    
+    // Warm up so the frame pool holds its buffers: steady state should
+    // report allocs_per_iter = 0
+    int frame = 0;
+    for (; frame < 4; ++frame) {
+        engine.renderFrame(frame);
+    }
+    
+    while (state.keepRunning()) {
+        cv::Mat image = engine.renderFrame(frame);
+        bench::doNotOptimize(image.data);
+        frame = (frame + 1) % config.totalFrames;
+    }
+    
+    state.counters["culled_draws"] = engine.getCulledDrawsPerFrame();
+    auto poolStats = engine.getFramePoolStats();
+    state.counters["pool_overflows"] = static_cast<double>(poolStats.overflows);
+}
+FOURIER_BENCHMARK(BM_renderFrame)
+    ->argNames({"backend", "height", "path", "circles", "dirty"})
+    ->argsProduct({{static_cast<int64_t>(fourier::RenderBackend::OpenCV),
+                    static_cast<int64_t>(fourier::RenderBackend::Cairo)},
+                   {720, 1080, 2160}, {0, 1}, {100, 1000}, {0, 1}});
+
+// Multi-contour frames: one circle budget split across `chains` chains,
+// so the cost should stay close to a single chain with the same circles
+void BM_renderChains(bench::State& state) {
+    fourier::AnimationConfig config;
+    config.backend = fourier::RenderBackend::OpenCV;
+    config.resolution = cv::Size(1920, 1080);
+    config.center = cv::Point2d(960.0, 540.0);
+    config.scale = 1080 * 0.37;
+    
+    auto shapes = bench::makeComplexShapes(static_cast<int>(state.range(0)), 500);
+    auto chains = fourier::computeDFTs(shapes, static_cast<int>(state.range(1)));
+    fourier::AnimationEngine engine;
+    engine.initialize(chains, config);
+    
+    int frame = 0;
+    for (; frame < 4; ++frame) {
+        engine.renderFrame(frame);
+    }
+    
+    while (state.keepRunning()) {
+        cv::Mat image = engine.renderFrame(frame);
+        bench::doNotOptimize(image.data);
+        frame = (frame + 1) % config.totalFrames;
+    }
+    
+    state.counters["culled_draws"] = engine.getCulledDrawsPerFrame();
+}
+FOURIER_BENCHMARK(BM_renderChains)
+    ->argNames({"chains", "circles"})
+    ->argsProduct({{1, 4, 16}, {100, 1000}});
+
+// format: OutputFormat value (2 = raw BGR, 3 = raw I420, 4 = Y4M), written
+// to /dev/null, so this is conversion plus buffered write cost; steady
+// state should report allocs_per_iter = 0
+void BM_frameSink(bench::State& state) {
+    const int height = static_cast<int>(state.range(1));
+    fourier::VideoConfig config;
+    config.format = static_cast<fourier::OutputFormat>(state.range(0));
+    config.width = height * 16 / 9;
+    config.height = height;
+    config.outputPath = "/dev/null";
+    
+    fourier::RawStreamSink sink(config.format);
+    if (!sink.open(config)) {
+        state.skipWithError("cannot open /dev/null");
+        return;
+    }
+    cv::Mat frame(height, config.width, CV_8UC3, cv::Scalar(40, 120, 200));
+    sink.write(frame, 1);
+    
+    while (state.keepRunning()) {
+        sink.write(frame, 1);
+    }
+    sink.close();
+}
+FOURIER_BENCHMARK(BM_frameSink)
+    ->argNames({"format", "height"})
+    ->argsProduct({{static_cast<int64_t>(fourier::OutputFormat::RawBGR),
+                    static_cast<int64_t>(fourier::OutputFormat::RawI420),
+                    static_cast<int64_t>(fourier::OutputFormat::Y4M)},
+                   {720, 1080, 2160}});
+
+// format: OutputFormat value (5 = PNG, 6 = QOI); one compression of a
+// rendered 1080p frame, the per-frame work of an image-sequence worker
+void BM_compressFrame(bench::State& state) {
+    const auto format = static_cast<fourier::OutputFormat>(state.range(0));
+    fourier::AnimationConfig config;
+    config.backend = fourier::RenderBackend::OpenCV;
+    config.scale = 1080 * 0.37;
+    fourier::AnimationEngine engine;
+    engine.initialize(bench::makeCoefficients(config.numCircles), config);
+    cv::Mat frame = engine.renderFrame(config.totalFrames / 2).clone();
+    
+    std::vector<uint8_t> encoded;
+    while (state.keepRunning()) {
+        if (format == fourier::OutputFormat::QoiSequence) {
+            fourier::ImageSequenceSink::encodeQoi(frame, encoded);
+        } else {
+            const int level = static_cast<int>(state.range(1));
+            cv::imencode(".png", frame, encoded, {cv::IMWRITE_PNG_COMPRESSION, level});
+        }
+        bench::doNotOptimize(encoded.data());
+    }
+    state.counters["compression_ratio"] = static_cast<double>(frame.total() * frame.elemSize()) /
+                                          std::max<size_t>(encoded.size(), 1);
+}
+FOURIER_BENCHMARK(BM_compressFrame)
+    ->argNames({"format", "level"})
+    ->args({static_cast<int64_t>(fourier::OutputFormat::PngSequence), 1})
+    ->args({static_cast<int64_t>(fourier::OutputFormat::PngSequence), 6})
+    ->args({static_cast<int64_t>(fourier::OutputFormat::QoiSequence), 0});
+
+} // namespace
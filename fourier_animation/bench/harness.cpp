@@ -0,0 +1,336 @@
+#include "harness.hpp"
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <thread>
+
+namespace bench {
+
+State::State(std::vector<int64_t> args, int64_t maxIterations)
+    : args(std::move(args)), maxIterations(maxIterations) {}
+
+bool State::keepRunning() {
+    if (!started) {
+        started = true;
+        resumeTiming();
+    }
+    if (!error.empty() || completed >= maxIterations) {
+        if (running) pauseTiming();
+        return false;
+    }
+    ++completed;
+    return true;
+}
+
+void State::pauseTiming() {
+    if (!running) return;
+    realSeconds += std::chrono::duration<double>(Clock::now() - realStart).count();
+    cpuSeconds += static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    allocations += allocationCount() - allocationStart;
+    running = false;
+}
+
+void State::resumeTiming() {
+    if (running) return;
+    allocationStart = allocationCount();
+    realStart = Clock::now();
+    cpuStart = std::clock();
+    running = true;
+}
+
+void State::skipWithError(const std::string& message) {
+    error = message;
+}
+
+Benchmark::Benchmark(std::string name, BenchmarkFunction function)
+    : name(std::move(name)), function(function) {}
+
+Benchmark* Benchmark::argNames(std::vector<std::string> names) {
+    this->names = std::move(names);
+    return this;
+}
+
+Benchmark* Benchmark::args(std::vector<int64_t> values) {
+    argSets.push_back(std::move(values));
+    return this;
+}
+
+Benchmark* Benchmark::argsProduct(const std::vector<std::vector<int64_t>>& values) {
+    std::vector<std::vector<int64_t>> product{{}};
+    for (const auto& choices : values) {
+        std::vector<std::vector<int64_t>> next;
+        for (const auto& prefix : product) {
+            for (int64_t value : choices) {
+                next.push_back(prefix);
+                next.back().push_back(value);
+            }
+        }
+        product = std::move(next);
+    }
+    for (auto& set : product) {
+        argSets.push_back(std::move(set));
+    }
+    return this;
+}
+
+namespace {
+
+std::vector<std::unique_ptr<Benchmark>>& registry() {
+    static std::vector<std::unique_ptr<Benchmark>> benchmarks;
+    return benchmarks;
+}
+
+struct Result {
+    std::string name;
+    int64_t iterations = 0;
+    double realNs = 0.0;   // Per iteration
+    double cpuNs = 0.0;
+    std::string label;
+    std::string error;
+    std::map<std::string, double> counters;
+};
+
+std::string jsonEscape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+void writeJson(std::ostream& out, const std::vector<Result>& results) {
+    char date[64];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    
+    out << "{\n  \"context\": {\n"
+        << "    \"date\": \"" << date << "\",\n"
+        << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+        << "    \"library_build_type\": \"release\",\n"
+#else
+        << "    \"library_build_type\": \"debug\",\n"
+#endif
+#ifdef FOURIER_PROFILING
+        << "    \"profiling\": true,\n"
+#else
+        << "    \"profiling\": false,\n"
+#endif
+#ifdef USE_CAIRO
+        << "    \"cairo\": true\n"
+#else
+        << "    \"cairo\": false\n"
+#endif
+        << "  },\n  \"benchmarks\": [\n";
+    
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        out << "    {\n"
+            << "      \"name\": \"" << jsonEscape(r.name) << "\",\n"
+            << "      \"run_name\": \"" << jsonEscape(r.name) << "\",\n"
+            << "      \"run_type\": \"iteration\",\n";
+        if (!r.error.empty()) {
+            out << "      \"error_occurred\": true,\n"
+                << "      \"error_message\": \"" << jsonEscape(r.error) << "\",\n";
+        }
+        if (!r.label.empty()) {
+            out << "      \"label\": \"" << jsonEscape(r.label) << "\",\n";
+        }
+        for (const auto& [key, value] : r.counters) {
+            out << "      \"" << jsonEscape(key) << "\": " << value << ",\n";
+        }
+        out << "      \"iterations\": " << r.iterations << ",\n"
+            << "      \"real_time\": " << r.realNs << ",\n"
+            << "      \"cpu_time\": " << r.cpuNs << ",\n"
+            << "      \"time_unit\": \"ns\"\n"
+            << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+void printRow(const Result& r) {
+    if (!r.error.empty()) {
+        std::printf("%-56s ERROR: %s\n", r.name.c_str(), r.error.c_str());
+        return;
+    }
+    std::printf("%-56s %14.0f %14.0f %12lld", r.name.c_str(), r.realNs, r.cpuNs,
+                static_cast<long long>(r.iterations));
+    for (const auto& [key, value] : r.counters) {
+        std::printf(" %s=%.3g", key.c_str(), value);
+    }
+    if (!r.label.empty()) std::printf(" %s", r.label.c_str());
+    std::printf("\n");
+    std::fflush(stdout);
+}
+
+struct Options {
+    std::string filter = ".*";
+    std::string format = "console";
+    std::string outPath;
+    double minTime = 0.5;
+    bool list = false;
+};
+
+Options parseOptions(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](const char* flag) -> const char* {
+            size_t length = std::strlen(flag);
+            if (arg.compare(0, length, flag) == 0 && arg.size() > length && arg[length] == '=') {
+                return argv[i] + length + 1;
+            }
+            return nullptr;
+        };
+        
+        if (const char* v = value("--benchmark_filter")) options.filter = v;
+        else if (const char* v = value("--benchmark_format")) options.format = v;
+        else if (const char* v = value("--benchmark_out")) options.outPath = v;
+        else if (const char* v = value("--benchmark_min_time")) options.minTime = std::stod(v);
+        else if (arg == "--benchmark_list_tests") options.list = true;
+        else if (arg == "--help") {
+            std::printf("Usage: %s [--benchmark_filter=<regex>] [--benchmark_min_time=<s>]\n"
+                        "       [--benchmark_format=console|json] [--benchmark_out=<file>]\n"
+                        "       [--benchmark_list_tests]\n", argv[0]);
+            std::exit(0);
+        }
+    }
+    return options;
+}
+
+// Discards library logging (std::cout) so JSON on stdout stays parseable
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+} // namespace
+
+Benchmark* registerBenchmark(const char* name, BenchmarkFunction function) {
+    registry().push_back(std::make_unique<Benchmark>(name, function));
+    return registry().back().get();
+}
+
+class Runner {
+public:
+    static Result run(const Benchmark& benchmark, const std::vector<int64_t>& args,
+                      const std::string& name, double minTime) {
+        Result result;
+        result.name = name;
+        
+        // Grow the iteration count until one run lasts minTime
+        int64_t iterations = 1;
+        while (true) {
+            State state(args, iterations);
+            benchmark.function(state);
+#ifdef FOURIER_PROFILING
+            // Keep the event buffers from growing across runs
+            fourier::Profiler::instance().clear();
+#endif
+            
+            if (!state.error.empty()) {
+                result.error = state.error;
+                return result;
+            }
+            
+            double seconds = state.realSeconds;
+            if (seconds >= minTime || iterations >= 1'000'000'000) {
+                result.iterations = state.completed;
+                result.realNs = seconds * 1e9 / std::max<int64_t>(state.completed, 1);
+                result.cpuNs = state.cpuSeconds * 1e9 / std::max<int64_t>(state.completed, 1);
+                result.label = state.label;
+                result.counters = state.counters;
+                result.counters["allocs_per_iter"] = static_cast<double>(state.allocations)
+                                                     / std::max<int64_t>(state.completed, 1);
+                return result;
+            }
+            
+            double multiplier = seconds > 0.0 ? minTime * 1.4 / seconds : 10.0;
+            multiplier = std::clamp(multiplier, 2.0, 10.0);
+            iterations = static_cast<int64_t>(iterations * multiplier) + 1;
+        }
+    }
+    
+    static std::string runName(const Benchmark& benchmark, const std::vector<int64_t>& args) {
+        std::ostringstream name;
+        name << benchmark.name;
+        for (size_t i = 0; i < args.size(); ++i) {
+            name << "/";
+            if (i < benchmark.names.size()) name << benchmark.names[i] << ":";
+            name << args[i];
+        }
+        return name.str();
+    }
+    
+    static int main(int argc, char* argv[]) {
+        Options options = parseOptions(argc, argv);
+        std::regex filter(options.filter);
+        const bool jsonToStdout = options.format == "json";
+        
+        std::vector<std::pair<const Benchmark*, std::vector<int64_t>>> selected;
+        for (const auto& benchmark : registry()) {
+            auto argSets = benchmark->argSets;
+            if (argSets.empty()) argSets.push_back({});
+            for (const auto& args : argSets) {
+                if (std::regex_search(runName(*benchmark, args), filter)) {
+                    selected.emplace_back(benchmark.get(), args);
+                }
+            }
+        }
+        
+        if (options.list) {
+            for (const auto& [benchmark, args] : selected) {
+                std::printf("%s\n", runName(*benchmark, args).c_str());
+            }
+            return 0;
+        }
+        
+        NullBuffer nullBuffer;
+        std::streambuf* coutBuffer = std::cout.rdbuf(&nullBuffer);
+        
+#ifdef FOURIER_PROFILING
+        // Timers compiled in are measured enabled, as with --profile
+        fourier::Profiler::instance().setEnabled(true);
+#endif
+        
+        if (!jsonToStdout) {
+            std::printf("%-56s %14s %14s %12s\n", "Benchmark", "Time (ns)", "CPU (ns)", "Iterations");
+            std::printf("%s\n", std::string(99, '-').c_str());
+        }
+        
+        std::vector<Result> results;
+        for (const auto& [benchmark, args] : selected) {
+            results.push_back(run(*benchmark, args, runName(*benchmark, args), options.minTime));
+            if (!jsonToStdout) printRow(results.back());
+        }
+        
+        std::cout.rdbuf(coutBuffer);
+        
+        if (jsonToStdout) {
+            writeJson(std::cout, results);
+        }
+        if (!options.outPath.empty()) {
+            std::ofstream out(options.outPath);
+            if (!out) {
+                std::fprintf(stderr, "Failed to write %s\n", options.outPath.c_str());
+                return 1;
+            }
+            writeJson(out, results);
+        }
+        return 0;
+    }
+};
+
+} // namespace bench
+
+int main(int argc, char* argv[]) {
+    return bench::Runner::main(argc, argv);
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+// Minimal Google-Benchmark-style harness for fourier_bench.
+//
+// Benchmarks register with FOURIER_BENCHMARK and loop on
+// `while (state.keepRunning())`. The iteration count grows until a run
+// lasts --benchmark_min_time. Results print as a table, and as JSON in
+// Google Benchmark's schema (so tools/compare.py can diff two commits)
+// with --benchmark_format=json or --benchmark_out=<file>. Heap
+// allocations inside the timed region are reported as allocs_per_iter.
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+class State {
+public:
+    State(std::vector<int64_t> args, int64_t maxIterations);
+    
+    /**
+     * @brief Advance the measured loop; false once maxIterations ran
+     */
+    bool keepRunning();
+    
+    int64_t range(size_t index) const { return args.at(index); }
+    int64_t iterations() const { return maxIterations; }
+    
+    /**
+     * @brief Exclude setup inside the loop from the measurement
+     */
+    void pauseTiming();
+    void resumeTiming();
+    
+    /**
+     * @brief Abort this benchmark (e.g. backend not compiled in)
+     */
+    void skipWithError(const std::string& message);
+    
+    void setLabel(const std::string& text) { label = text; }
+    
+    // Extra columns, reported as-is (e.g. "max_error")
+    std::map<std::string, double> counters;
+
+private:
+    friend class Runner;
+    
+    using Clock = std::chrono::steady_clock;
+    
+    std::vector<int64_t> args;
+    int64_t maxIterations;
+    int64_t completed = 0;
+    bool started = false;
+    bool running = false;
+    Clock::time_point realStart;
+    std::clock_t cpuStart = 0;
+    int64_t allocationStart = 0;
+    double realSeconds = 0.0;
+    double cpuSeconds = 0.0;
+    int64_t allocations = 0;
+    std::string label;
+    std::string error;
+};
+
+using BenchmarkFunction = void (*)(State&);
+
+/**
+ * @brief Heap allocations so far (operator new and cv::Mat buffers)
+ */
+int64_t allocationCount();
+
+/**
+ * @brief A registered benchmark and its parameter sets
+ */
+class Benchmark {
+public:
+    Benchmark(std::string name, BenchmarkFunction function);
+    
+    /**
+     * @brief Name the arguments ("circles" -> BM_x/circles:100)
+     */
+    Benchmark* argNames(std::vector<std::string> names);
+    
+    /**
+     * @brief Add one parameter set
+     */
+    Benchmark* args(std::vector<int64_t> values);
+    
+    /**
+     * @brief Add the cartesian product of per-argument value lists
+     */
+    Benchmark* argsProduct(const std::vector<std::vector<int64_t>>& values);
+
+private:
+    friend class Runner;
+    
+    std::string name;
+    BenchmarkFunction function;
+    std::vector<std::string> names;
+    std::vector<std::vector<int64_t>> argSets;
+};
+
+Benchmark* registerBenchmark(const char* name, BenchmarkFunction function);
+
+/**
+ * @brief Keep a value alive so the compiler cannot drop the computation
+ */
+template<typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static const void* volatile sink;
+    sink = &value;
+#endif
+}
+
+} // namespace bench
+
+#define FOURIER_BENCH_CONCAT_INNER(a, b) a##b
+#define FOURIER_BENCH_CONCAT(a, b) FOURIER_BENCH_CONCAT_INNER(a, b)
+
+#define FOURIER_BENCHMARK(function) \
+    static ::bench::Benchmark* FOURIER_BENCH_CONCAT(benchmark_, __LINE__) = \
+        ::bench::registerBenchmark(#function, function)
@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+"""Overhead of the FOURIER_PROFILING timers on renderFrame.
+
+Runs fourier_bench (timers compiled out) and fourier_bench_profiled
+(timers compiled in and enabled) on the same benchmarks and prints the
+time ratio of every run, plus the median and worst overhead.
+
+    python3 bench/profile_overhead.py build [--filter=BM_renderFrame] [--min-time=0.5]
+
+Exits with 1 when the median overhead exceeds --max-overhead (percent).
+"""
+
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+
+
+def run(binary, bench_filter, min_time):
+    output = subprocess.run(
+        [binary, "--benchmark_filter=" + bench_filter,
+         "--benchmark_min_time=" + str(min_time), "--benchmark_format=json"],
+        check=True, stdout=subprocess.PIPE).stdout
+    report = json.loads(output)
+    return report["context"], {b["name"]: b for b in report["benchmarks"]
+                               if not b.get("error_occurred")}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("build_dir")
+    parser.add_argument("--filter", default="BM_renderFrame")
+    parser.add_argument("--min-time", type=float, default=0.5)
+    parser.add_argument("--max-overhead", type=float, default=1.0)
+    args = parser.parse_args()
+
+    off_context, off = run(os.path.join(args.build_dir, "fourier_bench"),
+                           args.filter, args.min_time)
+    on_context, on = run(os.path.join(args.build_dir, "fourier_bench_profiled"),
+                         args.filter, args.min_time)
+    if off_context.get("profiling") or not on_context.get("profiling"):
+        sys.exit("fourier_bench must be built without FOURIER_PROFILING")
+
+    overheads = []
+    print("%-64s %12s %12s %9s" % ("Benchmark", "off (ns)", "on (ns)", "overhead"))
+    for name, base in off.items():
+        if name not in on:
+            continue
+        ratio = on[name]["real_time"] / base["real_time"]
+        overheads.append(100.0 * (ratio - 1.0))
+        print("%-64s %12.0f %12.0f %8.2f%%" % (name, base["real_time"],
+                                               on[name]["real_time"], overheads[-1]))
+    if not overheads:
+        sys.exit("No benchmark ran in both builds")
+
+    median = statistics.median(overheads)
+    print("median overhead %.2f%%, worst %.2f%%" % (median, max(overheads)))
+    return 0 if median <= args.max_overhead else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,91 @@
+#pragma once
+
+// Synthetic inputs for fourier_bench, so runs do not depend on images.
+
+#include "fourier.hpp"
+
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <random>
+#include <vector>
+#include <opencv2/core.hpp>
+
+namespace bench {
+
+constexpr double TWO_PI = 2.0 * std::numbers::pi;
+
+/**
+ * @brief Closed star outline (pixel contour, like findContours output)
+ */
+inline std::vector<cv::Point> makeStarContour(int numPoints, int spikes = 7,
+                                              double radius = 400.0) {
+    std::vector<cv::Point> contour;
+    contour.reserve(numPoints);
+    for (int i = 0; i < numPoints; ++i) {
+        double theta = TWO_PI * i / numPoints;
+        double r = radius * (0.65 + 0.35 * std::cos(spikes * theta));
+        contour.emplace_back(static_cast<int>(std::lround(radius + r * std::cos(theta))),
+                             static_cast<int>(std::lround(radius + r * std::sin(theta))));
+    }
+    return contour;
+}
+
+/**
+ * @brief Epitrochoid-like closed curve normalised to max radius 1
+ */
+inline std::vector<std::complex<double>> makeComplexShape(int numPoints) {
+    std::vector<std::complex<double>> points;
+    points.reserve(numPoints);
+    for (int i = 0; i < numPoints; ++i) {
+        double theta = TWO_PI * i / numPoints;
+        points.push_back(0.6 * std::polar(1.0, theta)
+                         + 0.3 * std::polar(1.0, -4.0 * theta)
+                         + 0.1 * std::polar(1.0, 11.0 * theta));
+    }
+    return points;
+}
+
+/**
+ * @brief Several shapes in one normalization, each smaller and off-center
+ *        (like extractContours output for a multi-stroke logo)
+ */
+inline std::vector<std::vector<std::complex<double>>> makeComplexShapes(int count, int numPoints) {
+    auto base = makeComplexShape(numPoints);
+    std::vector<std::vector<std::complex<double>>> shapes;
+    shapes.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const double size = 1.0 / (i + 1);
+        const auto offset = std::polar(1.0 - size, TWO_PI * i / count);
+        std::vector<std::complex<double>> shape;
+        shape.reserve(base.size());
+        for (const auto& z : base) {
+            shape.push_back(offset + size * z);
+        }
+        shapes.push_back(std::move(shape));
+    }
+    return shapes;
+}
+
+/**
+ * @brief Spectrum with 1/k amplitude decay, sorted like computeDFT output
+ */
+inline std::vector<fourier::FourierCoefficient> makeCoefficients(int count) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> phaseDist(-std::numbers::pi, std::numbers::pi);
+    
+    std::vector<fourier::FourierCoefficient> coefficients;
+    coefficients.reserve(count);
+    for (int k = 0; k < count; ++k) {
+        fourier::FourierCoefficient coef;
+        coef.frequency = (k % 2 == 0) ? (k / 2 + 1) : -(k / 2 + 1);
+        coef.amplitude = 1.0 / (k + 1);
+        coef.phase = phaseDist(rng);
+        coef.cn = std::polar(coef.amplitude, coef.phase);
+        coef.color = cv::Scalar(255, 255, 255);
+        coefficients.push_back(coef);
+    }
+    return coefficients;
+}
+
+} // namespace bench
@@ -1,12 +1,29 @@
 #pragma once
 
 #include "fourier.hpp"
+#include "epicycle_kernel.hpp"
+#include "frame_pool.hpp"
 #include <opencv2/core.hpp>
 #include <opencv2/imgproc.hpp>
+#include <memory>
+#include <span>
 #include <vector>
 
+#ifdef USE_CAIRO
+typedef struct _cairo cairo_t;
+#endif
+
 namespace fourier {
 
+/**
+ * @brief Rasterizer used by AnimationEngine
+ */
+enum class RenderBackend {
+    Auto,    // Cairo when compiled in, otherwise OpenCV
+    OpenCV,
+    Cairo    // Falls back to OpenCV without USE_CAIRO
+};
+
 /**
  * @brief Animation configuration
  */
@@ -28,6 +45,35 @@ struct AnimationConfig {
     bool showPath = true;
     bool showOriginMarker = true;
     
+    // Epicycle evaluation: phasor recurrence, or a stateless SoA kernel
+    bool usePhasorEvaluator = true;
+    KernelType kernel = KernelType::Auto;  // Used when usePhasorEvaluator is false
+    
+    // KernelType::Table: largest pen position error allowed (pixels at
+    // `scale`); the smallest sine table meeting it is used, or exact trig
+    // when no table does
+    double trigMaxPixelError = 0.1;
+    
+    RenderBackend backend = RenderBackend::Auto;
+    
+    // Output frames that may be in flight at once (held by the caller or
+    // queued in the encoder); buffers are reused once released
+    int framePoolSize = 12;
+    
+    // Refresh only the regions that changed since a pooled frame was last
+    // drawn (previous and current chain bounds, new path segments) from the
+    // cached path layer, instead of copying the whole frame
+    bool dirtyRectangles = true;
+    
+    // Level of detail: trailing terms whose summed radii stay below this
+    // many pixels are drawn as one combined vector (the pen position still
+    // uses every term). 0 draws every term.
+    double lodPixelError = 0.5;
+    
+    // Traced path resolution: the pen trajectory is sampled this many times
+    // per frame (raised when needed to avoid aliasing high frequencies)
+    int pathSamplesPerFrame = 8;
+    
     // Animation center offset (to center in frame)
     cv::Point2d center{960, 540};
     double scale = 400.0;  // Scale factor for visualization
@@ -49,18 +95,69 @@ public:
     void initialize(const std::vector<FourierCoefficient>& coefficients,
                    const AnimationConfig& config = AnimationConfig());
     
+    /**
+     * @brief Initialize with several epicycle chains drawn in the same frame
+     * 
+     * Every chain traces its own shape around config.center, in the same
+     * coefficient units (see computeDFTs). They share the frame, the path
+     * layer and the trig kernel; each gets its own LOD cutoff.
+     * 
+     * @param chains Fourier coefficients of each shape
+     * @param config Animation configuration (numCircles is not used)
+     */
+    void initialize(const std::vector<std::vector<FourierCoefficient>>& chains,
+                   const AnimationConfig& config = AnimationConfig());
+    
+    /**
+     * @brief Replace the coefficients, keeping configuration and buffers
+     * 
+     * For live input, where the shape changes every frame: the evaluator,
+     * trajectory and LOD are rebuilt and the traced path starts over, while
+     * the frame pool and drawing surfaces are reused.
+     */
+    void setCoefficients(const std::vector<FourierCoefficient>& coefficients);
+    
+    /**
+     * @brief Replace the coefficients and where they are drawn
+     * @param center Screen position of the origin
+     * @param scale Pixels per coefficient unit
+     */
+    void setCoefficients(const std::vector<FourierCoefficient>& coefficients,
+                         const cv::Point2d& center, double scale);
+    
     /**
      * @brief Render a single frame at time t
+     * 
+     * The traced path is reconstructed from the frame index, so frames can
+     * be rendered in any order (e.g. by several engines in parallel).
+     * 
      * @param frameIndex Current frame index (0 to totalFrames-1)
-     * @return Rendered frame
+     * @return Rendered frame (a pooled buffer, recycled once every copy of
+     *         the returned header is released)
      */
     cv::Mat renderFrame(int frameIndex);
     
     /**
-     * @brief Get the path traced so far
-     * @return Vector of path points
+     * @brief Get the path traced so far by one chain
+     * @param chain Chain index (0 for single-shape animations)
+     * @return Sub-pixel screen points, a prefix of the precomputed trajectory
+     */
+    std::span<const cv::Point2d> getTracedPath(size_t chain = 0) const;
+    
+    /**
+     * @brief Number of epicycle chains drawn per frame
+     */
+    size_t getChainCount() const;
+    
+    /**
+     * @brief Circle/vector draw calls saved per frame by LOD folding
+     */
+    int getCulledDrawsPerFrame() const;
+    
+    /**
+     * @brief Usage of the pool that renderFrame() draws into
      */
-    const std::vector<cv::Point>& getTracedPath() const;
+    FramePoolStats getFramePoolStats() const;
     
     /**
      * @brief Reset animation state
@@ -79,25 +176,28 @@ public:
 
 private:
     class Impl;
+    struct Chain;
     std::unique_ptr<Impl> pImpl;
     
     // OpenCV rendering methods
-    cv::Mat renderFrameOpenCV(const std::vector<cv::Point2d>& positions, double t);
-    void drawCircles(cv::Mat& frame, const std::vector<cv::Point2d>& positions, double t);
-    void drawVectors(cv::Mat& frame, const std::vector<cv::Point2d>& positions);
-    void drawPath(cv::Mat& frame);
+    cv::Mat renderFrameOpenCV(double t);
+    void drawCircles(cv::Mat& frame, const Chain& chain, double t);
+    void drawVectors(cv::Mat& frame, const Chain& chain);
+    cv::Rect drawPath(cv::Mat& layer);
     void drawOriginMarker(cv::Mat& frame);
-    
+
 #ifdef USE_CAIRO
     // Cairo rendering methods (high-quality)
-    cv::Mat renderFrameCairo(const std::vector<cv::Point2d>& positions, double t);
-    void drawCirclesCairo(struct _cairo* cr, const std::vector<cv::Point2d>& positions);
-    void drawVectorsCairo(struct _cairo* cr, const std::vector<cv::Point2d>& positions);
-    void drawPathCairo(struct _cairo* cr);
-    void drawOriginMarkerCairo(struct _cairo* cr);
+    cv::Mat renderFrameCairo(double t);
+    void drawCirclesCairo(cairo_t* cr, const Chain& chain);
+    void drawVectorsCairo(cairo_t* cr, const Chain& chain);
+    cv::Rect drawPathCairo(cairo_t* cr);
+    void drawOriginMarkerCairo(cairo_t* cr);
 #endif
-    
+
     cv::Point worldToScreen(const cv::Point2d& worldPoint) const;
+    cv::Rect chainBounds(const Chain& chain) const;
+    double pathSegmentAlpha(size_t segmentIndex) const;
 };
 
 } // namespace fourier
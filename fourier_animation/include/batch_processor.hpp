@@ -0,0 +1,98 @@
+#pragma once
+
+#include "fourier.hpp"
+#include "contour_extractor.hpp"
+#include "animation.hpp"
+#include "video_writer.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fourier {
+
+class CoefficientCache;
+
+/**
+ * @brief Batch scheduling configuration
+ */
+struct BatchConfig {
+    std::string outputDir = "batch_output";  // One <image stem>.mp4 per input (_2, _3 for repeated stems)
+    std::string summaryPath;                 // Default: <outputDir>/batch_summary.json
+    int renderWorkers = 2;                   // Jobs processed concurrently
+    int maxEncoders = 1;                     // Encode threads shared by the render workers
+};
+
+/**
+ * @brief Outcome and per-stage timing of one batch job
+ */
+struct JobResult {
+    std::string imagePath;
+    std::string outputPath;
+    bool success = false;
+    std::string errorMessage;
+    int frames = 0;
+    double contourMs = 0.0;
+    double dftMs = 0.0;
+    double renderMs = 0.0;
+    double encodeMs = 0.0;
+    double totalMs = 0.0;
+    
+    double framesPerSecond() const {
+        return totalMs > 0.0 ? frames * 1000.0 / totalMs : 0.0;
+    }
+};
+
+/**
+ * @brief Turns many images into videos in one process
+ *
+ * Jobs run on a pool of render workers, each reusing one AnimationEngine
+ * (and its surfaces) across jobs; FFT plans are shared through
+ * FFTPlanCache. Encoding runs on a separate, fixed pool of maxEncoders
+ * threads: workers hand frames to the encoder their job is pinned to
+ * through a bounded queue and keep rendering, waiting only when that
+ * queue is full. A failing job is recorded and the batch continues.
+ * With a CoefficientCache, every worker looks up and stores spectra in
+ * the same instance.
+ */
+class BatchProcessor {
+public:
+    BatchProcessor(const BatchConfig& batchConfig,
+                   const ContourConfig& contourConfig,
+                   const AnimationConfig& animConfig,
+                   const VideoConfig& videoConfig,
+                   const DFTOptions& dftOptions = DFTOptions());
+    ~BatchProcessor();
+    
+    /**
+     * @brief Reuse spectra across runs (and across images with equal content)
+     * @param cache Shared by all render workers; must outlive run(). nullptr: none
+     */
+    void setCoefficientCache(CoefficientCache* cache);
+    
+    /**
+     * @brief Collect input images from a directory or a list file
+     * @param dirOrList Directory (image files, sorted by name) or text file
+     *                  with one image path per line ('#' starts a comment)
+     * @return Image paths
+     */
+    static std::vector<std::string> collectInputs(const std::string& dirOrList);
+    
+    /**
+     * @brief Process all images and write the summary file
+     * @param images Input image paths
+     * @return One result per image, in input order
+     */
+    std::vector<JobResult> run(const std::vector<std::string>& images);
+    
+    /**
+     * @brief Write job results as JSON
+     * @return true if the file was written
+     */
+    static bool writeSummary(const std::vector<JobResult>& results, const std::string& path);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+} // namespace fourier
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "fourier.hpp"
+#include "animation.hpp"
+#include "video_writer.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace fourier {
+
+/**
+ * @brief Half-open range of animation frames [start, end)
+ */
+struct FrameRange {
+    int start = 0;
+    int end = -1;   // -1: up to the last frame of the animation
+    
+    int size() const { return std::max(end - start, 0); }
+};
+
+/**
+ * @brief Parse "start:end" ("start:" and ":end" leave that side open)
+ * @return false if the text is not a range
+ */
+bool parseFrameRange(const std::string& text, FrameRange& range);
+
+/**
+ * @brief Clamp a range to an animation's frames, resolving an open end
+ */
+FrameRange clampFrameRange(const FrameRange& range, int totalFrames);
+
+/**
+ * @brief Split a range into up to `chunks` nearly equal chunks
+ *
+ * Inner boundaries are moved to the nearest keyframe, i.e. a frame b with
+ * (b + keyframeOffset) % keyframeInterval == 0, where keyframeOffset is
+ * the number of output frames before animation frame 0 (the intro hold).
+ * Each chunk is encoded separately and starts with a keyframe, so
+ * concatenated chunks keep a single encode's keyframe cadence (as long as
+ * the encoder honours VideoConfig::keyframeInterval). Chunks emptied by
+ * the alignment are dropped.
+ */
+std::vector<FrameRange> splitFrameRange(const FrameRange& range, int chunks,
+                                        int keyframeInterval, int keyframeOffset = 0);
+
+/**
+ * @brief Output path of chunk `index`: <stem>.partNNN<extension> next to outputPath
+ *        (for stdout, fourier_stream_<pid>.partNNN.y4m in the temp directory)
+ */
+std::string chunkPath(const std::string& outputPath, int index);
+
+/**
+ * @brief Join chunk outputs without re-encoding
+ *
+ * Containers go through ffmpeg's concat demuxer with -c copy; Y4M chunks
+ * are appended without their stream headers after the first; raw chunks
+ * are appended as they are. Image sequences need no merge (chunks write
+ * their files under their own frame numbers).
+ *
+ * @param chunks Chunk files, in frame order
+ * @param outputPath Merged output
+ * @param format Format of the chunks and the output
+ * @param errorMessage Set when merging fails
+ * @return true on success
+ */
+bool concatenateChunks(const std::vector<std::string>& chunks, const std::string& outputPath,
+                       OutputFormat format, std::string* errorMessage = nullptr);
+
+/**
+ * @brief Outcome and timing of a chunked render
+ */
+struct ChunkedRenderStats {
+    bool success = false;
+    std::string errorMessage;
+    int chunks = 0;
+    int frames = 0;             // Animation frames rendered (without holds)
+    double wallSeconds = 0.0;   // Render and encode of every chunk
+    double mergeSeconds = 0.0;  // Concatenation
+};
+
+/**
+ * @brief Renders a frame range as independent chunks, each with its own
+ *        engine and encoder, then concatenates them
+ *
+ * A single encoder caps long high-resolution renders; here every chunk
+ * runs on its own thread into its own VideoWriter. No chunk replays the
+ * frames before its start: the engine rebuilds the traced path up to any
+ * frame directly. The intro hold is written only by a chunk starting at
+ * frame 0, and the end hold only by one ending at the last frame, so the
+ * merged output matches an unsharded render.
+ *
+ * Chunk files are removed after a successful merge and kept otherwise.
+ */
+class ChunkedRenderer {
+public:
+    /**
+     * @param numChunks Chunks rendered concurrently (at least 1)
+     */
+    explicit ChunkedRenderer(int numChunks);
+    
+    void initialize(const std::vector<std::vector<FourierCoefficient>>& chains,
+                    const AnimationConfig& animConfig, const VideoConfig& videoConfig);
+    
+    /**
+     * @brief Render a range into videoConfig.outputPath
+     * @param range Frames to render (clamped to the animation)
+     */
+    ChunkedRenderStats render(const FrameRange& range);
+    
+    /**
+     * @brief Render one chunk into its own writer (any thread)
+     * @param videoConfig Output of this chunk
+     * @return false if the output could not be written
+     */
+    static bool renderChunk(const std::vector<std::vector<FourierCoefficient>>& chains,
+                            const AnimationConfig& animConfig, const VideoConfig& videoConfig,
+                            const FrameRange& range, std::string* errorMessage = nullptr);
+
+private:
+    int numChunks;
+    std::vector<std::vector<FourierCoefficient>> chains;
+    AnimationConfig animConfig;
+    VideoConfig videoConfig;
+};
+
+} // namespace fourier
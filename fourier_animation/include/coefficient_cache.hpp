@@ -0,0 +1,127 @@
+#pragma once
+
+#include "fourier.hpp"
+#include "contour_extractor.hpp"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace fourier {
+
+/**
+ * @brief Epicycle chains: one coefficient list per animated contour
+ */
+using CoefficientChains = std::vector<std::vector<FourierCoefficient>>;
+
+/**
+ * @brief Coefficient file format
+ *
+ * Little-endian, every field at its natural alignment, so a mapped file
+ * can be read in place:
+ *
+ *   offset 0   char[4]  magic "FCOF"
+ *          4   uint16   version (kCoefficientFileVersion)
+ *          6   uint16   flags (kCoefficientHalf: float16 values)
+ *          8   uint32   chain count C
+ *         12   uint32   reserved (0)
+ *         16   uint32[C] term count of each chain, padded to 8 bytes
+ *   then each chain's terms, largest amplitude first:
+ *     float64: int32 frequency, int32 reserved, float64 re, float64 im  (24 bytes)
+ *     float16: int32 frequency, float16 re, float16 im                  (8 bytes)
+ *
+ * Only frequency and cn are stored; amplitude, phase and colors are
+ * derived on load. float16 keeps about 3 significant digits (well under
+ * a pixel for the usual normalized shapes) at a third of the size.
+ */
+constexpr uint16_t kCoefficientFileVersion = 1;
+constexpr uint16_t kCoefficientHalf = 1;
+
+/**
+ * @brief Write chains to a coefficient file
+ * @param halfPrecision Store re/im as float16
+ * @return true on success
+ */
+bool saveCoefficients(const std::string& path, const CoefficientChains& chains,
+                      bool halfPrecision = false);
+
+/**
+ * @brief Read a coefficient file (memory-mapped)
+ *
+ * Each chain is re-sorted by amplitude and gets computeDFT's rank-order
+ * colors (see assignColors), so loaded chains draw exactly like fresh ones.
+ *
+ * @param chains Output chains (replaced)
+ * @param errorMessage Set when loading fails
+ * @return true on success
+ */
+bool loadCoefficients(const std::string& path, CoefficientChains& chains,
+                      std::string* errorMessage = nullptr);
+
+/**
+ * @brief Coefficient cache statistics
+ */
+struct CoefficientCacheStats {
+    int hits = 0;
+    int misses = 0;
+    int stores = 0;
+    int evictions = 0;
+};
+
+/**
+ * @brief On-disk cache of full spectra, keyed by image content and settings
+ *
+ * Entries are coefficient files named by a 64-bit FNV-1a hash of the
+ * image file's bytes, every ContourConfig field, the DFT options and the
+ * contour count, so any change to the input or to extraction misses.
+ * Spectra are stored untruncated: one entry serves every --circles value.
+ *
+ * Least recently used entries are evicted (by modification time, which a
+ * hit refreshes) once the directory grows past maxBytes. Entries are
+ * written to a temporary file (named per process and thread) and renamed,
+ * so concurrent writers never see a partial file. Temporary files count
+ * toward maxBytes and are removed once an hour old (left by a writer that
+ * died mid-store). One instance may be shared by several threads (the
+ * batch workers); the statistics are updated under a lock.
+ */
+class CoefficientCache {
+public:
+    CoefficientCache(const std::string& directory, uint64_t maxBytes);
+    
+    /**
+     * @brief Cache key of an image and its settings
+     * @return 0 if the image cannot be read
+     */
+    static uint64_t key(const std::string& imagePath, const ContourConfig& contourConfig,
+                        const DFTOptions& dftOptions, int maxContours);
+    
+    /**
+     * @brief Load the spectra stored under a key
+     * @return false on a miss (or an unreadable entry, which is removed)
+     */
+    bool load(uint64_t key, CoefficientChains& spectra);
+    
+    /**
+     * @brief Store spectra under a key, then evict down to the size limit
+     */
+    bool store(uint64_t key, const CoefficientChains& spectra);
+    
+    /**
+     * @brief Remove stale temporary files, then least recently used entries
+     *        until the cache fits maxBytes
+     */
+    void evict();
+    
+    std::string entryPath(uint64_t key) const;
+    CoefficientCacheStats getStats() const;
+
+private:
+    void count(int CoefficientCacheStats::* counter);
+    
+    std::string directory;
+    uint64_t maxBytes;
+    mutable std::mutex statsMutex;
+    CoefficientCacheStats stats;
+};
+
+} // namespace fourier
@@ -9,6 +9,14 @@
 
 namespace fourier {
 
+/**
+ * @brief Size measure used to pick contours
+ */
+enum class ContourMetric {
+    ArcLength,  // Outline length (favors detailed outlines)
+    Area        // Enclosed area (favors solid shapes over thin noise)
+};
+
 /**
  * @brief Configuration for contour extraction
  */
@@ -20,6 +28,11 @@ struct ContourConfig {
     bool useAdaptiveThreshold = true;
     int adaptiveBlockSize = 11;
     double adaptiveC = 2.0;
+    
+    // Contour selection: the largest by selectBy; with mergeNested the
+    // holes inside it are joined into its outline (letters like 'O', 'B')
+    ContourMetric selectBy = ContourMetric::ArcLength;
+    bool mergeNested = false;
 };
 
 /**
@@ -34,6 +47,22 @@ struct ContourResult {
     std::string errorMessage;
 };
 
+/**
+ * @brief Several contours of one image, in a shared normalization
+ *
+ * All shapes are centered on the centroid of every sampled point and
+ * scaled by one factor, so their coefficients can be compared and drawn
+ * together around a single origin.
+ */
+struct MultiContourResult {
+    std::vector<std::vector<std::complex<double>>> shapes;  // Largest first
+    std::vector<std::vector<cv::Point>> originalContours;
+    cv::Point2d centroid;                                   // Shared center
+    double scale;                                           // Shared scale factor
+    bool success;
+    std::string errorMessage;
+};
+
 /**
  * @brief Load image and extract the largest contour
  * @param imagePath Path to input image
@@ -50,6 +79,112 @@ ContourResult extractContour(const std::string& imagePath, const ContourConfig&
  */
 ContourResult extractContour(const cv::Mat& image, const ContourConfig& config = ContourConfig());
 
+/**
+ * @brief Load image and extract its largest contours
+ * @param imagePath Path to input image
+ * @param maxContours Number of contours to keep (all if <= 0)
+ * @param config Contour extraction configuration
+ * @return MultiContourResult, ranked by config.selectBy
+ */
+MultiContourResult extractContours(const std::string& imagePath, int maxContours,
+                                   const ContourConfig& config = ContourConfig());
+
+/**
+ * @brief Contour extractor for streams of frames
+ *
+ * Keeps its gray, blurred and edge images (and the contour list) between
+ * calls, so frames of the same size are processed without reallocating
+ * them. One instance per thread.
+ */
+class ContourExtractor {
+public:
+    explicit ContourExtractor(const ContourConfig& config = ContourConfig());
+    
+    /**
+     * @brief Extract the largest contour of a frame
+     * @param image Input image (grayscale or BGR)
+     * @return ContourResult with complex points
+     */
+    ContourResult extract(const cv::Mat& image);
+    
+    /**
+     * @brief Extract the largest contour inside a region of a frame
+     * 
+     * Used for tracking: only pixels inside roi are processed. The work
+     * images stay at full frame size and the region is written through
+     * views, so a moving ROI does not reallocate them.
+     * 
+     * @param image Input image (grayscale or BGR)
+     * @param roi Search region (clipped to the image)
+     * @return ContourResult; contour points are in image coordinates
+     */
+    ContourResult extract(const cv::Mat& image, const cv::Rect& roi);
+    
+    /**
+     * @brief Extract the largest contours of a frame
+     * 
+     * Each contour is sampled with numSamplePoints points; all are then
+     * normalized together.
+     * 
+     * @param image Input image (grayscale or BGR)
+     * @param maxContours Number of contours to keep (all if <= 0)
+     * @return MultiContourResult, ranked by config.selectBy
+     */
+    MultiContourResult extractMultiple(const cv::Mat& image, int maxContours);
+    
+    void setConfig(const ContourConfig& config) { this->config = config; }
+    const ContourConfig& getConfig() const { return config; }
+
+private:
+    // Preprocess the region and find its contours into `contours`
+    bool detect(const cv::Mat& image, const cv::Rect& roi, std::string& errorMessage);
+    
+    ContourConfig config;
+    cv::Mat gray;
+    cv::Mat blurred;
+    cv::Mat edges;
+    std::vector<std::vector<cv::Point>> contours;
+    std::vector<cv::Vec4i> hierarchy;  // Filled when merging nested contours
+};
+
+/**
+ * @brief Rank contours by size, computing each metric once
+ * 
+ * Metrics are computed in parallel for large contour counts (noisy photos
+ * produce thousands).
+ * 
+ * @param contours Candidate contours
+ * @param metric Size measure
+ * @param k Number of contours to return (all if <= 0)
+ * @param hierarchy If given (findContours hierarchy), only outer contours
+ *                  (no parent) are ranked
+ * @return Indices of the k largest contours, largest first
+ */
+std::vector<int> selectContours(
+    const std::vector<std::vector<cv::Point>>& contours,
+    ContourMetric metric,
+    int k = 1,
+    const std::vector<cv::Vec4i>* hierarchy = nullptr
+);
+
+/**
+ * @brief Join the holes of a contour into its outline
+ * 
+ * Each direct child is spliced in at its point closest to the outline, with
+ * a zero-width bridge walked in both directions, so one closed path traces
+ * the outline and every hole.
+ * 
+ * @param contours Contours from findContours
+ * @param hierarchy Matching hierarchy (RETR_CCOMP or RETR_TREE)
+ * @param outer Index of the outer contour
+ * @return Combined closed path
+ */
+std::vector<cv::Point> mergeNestedContours(
+    const std::vector<std::vector<cv::Point>>& contours,
+    const std::vector<cv::Vec4i>& hierarchy,
+    int outer
+);
+
 /**
  * @brief Sample points uniformly along a contour
  * @param contour Input contour points
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "fourier.hpp"
+#include <opencv2/core.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace fourier {
+
+/**
+ * @brief Minimal aligned allocator so SoA arrays start on a cache line
+ */
+template <typename T, size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+    
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+    
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+    
+    T* allocate(size_t n) {
+        void* p = ::operator new(n * sizeof(T), std::align_val_t(Alignment));
+        return static_cast<T*>(p);
+    }
+    
+    void deallocate(T* p, size_t) {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+    
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+/**
+ * @brief Packed structure-of-arrays view of the coefficients
+ *
+ * Only the data swept every frame: frequency and the complex coefficient
+ * split into amplitude*cos(phase) and amplitude*sin(phase).
+ */
+struct CoefficientSoA {
+    AlignedVector<double> frequency;
+    AlignedVector<double> re;   // amplitude * cos(phase)
+    AlignedVector<double> im;   // amplitude * sin(phase)
+    
+    size_t size() const { return frequency.size(); }
+    
+    static CoefficientSoA fromCoefficients(const std::vector<FourierCoefficient>& coefficients);
+};
+
+/**
+ * @brief Epicycle evaluation kernels
+ */
+enum class KernelType {
+    Auto,    // Best kernel supported by this CPU
+    Scalar,  // Portable std::cos/std::sin loop
+    AVX2,    // x86-64 AVX2 + FMA, 4 terms per iteration
+    NEON,    // AArch64 Advanced SIMD, 2 terms per iteration
+    Table    // Interpolated sine table (approximate, see SineTable)
+};
+
+/**
+ * @brief Sine lookup table with linear interpolation for approximate trig
+ *
+ * Holds 2^log2Size samples of one period; cos is read a quarter period
+ * ahead. Linear interpolation keeps each component within (2*pi/size)^2 / 8
+ * of the exact value, so the error of every term, and of the chain, is
+ * known before rendering.
+ */
+class SineTable {
+public:
+    static constexpr int MIN_LOG2_SIZE = 10;
+    static constexpr int MAX_LOG2_SIZE = 16;
+    
+    explicit SineTable(int log2Size = 12);
+    
+    int size() const { return static_cast<int>(mask + 1); }
+    
+    /**
+     * @brief Largest distance between an interpolated and the exact unit phasor
+     */
+    double maxPhasorError() const;
+    
+    /**
+     * @brief maxPhasorError of a 2^log2Size table, without building it
+     */
+    static double maxPhasorError(int log2Size);
+    
+    /**
+     * @brief Worst-case pen position error in pixels at the given scale
+     */
+    double positionErrorBound(const CoefficientSoA& soa, double scale) const;
+    
+    /**
+     * @brief Smallest table size whose bound stays within maxPixelError
+     * @return log2 of the size, or 0 if even the largest table is too coarse
+     */
+    static int chooseLog2Size(const CoefficientSoA& soa, double scale, double maxPixelError);
+    
+    /**
+     * @brief Default 2^12 table used by KernelType::Table without an explicit table
+     */
+    static const SineTable& shared();
+
+private:
+    static double amplitudeSum(const CoefficientSoA& soa);
+    
+    friend void evaluateEpicycles(const CoefficientSoA& soa, double t,
+                                  std::vector<cv::Point2d>& positions,
+                                  const SineTable& table);
+    
+    AlignedVector<double> values;  // size + size/4 + 1 samples (cos offset, wrap)
+    uint32_t mask;
+    double indexScale;             // size / (2*pi)
+};
+
+/**
+ * @brief Resolve Auto (or an unsupported kernel) to a kernel this CPU can run
+ */
+KernelType resolveKernel(KernelType requested);
+
+/**
+ * @brief Check whether a kernel was compiled in and is supported at runtime
+ */
+bool isKernelSupported(KernelType kernel);
+
+const char* kernelName(KernelType kernel);
+
+/**
+ * @brief Compute all epicycle positions at time t with the given kernel
+ *
+ * Same result and layout as getEpicyclePositions: positions[0] is the origin
+ * and positions[k + 1] is the prefix sum of the first k + 1 terms. SIMD
+ * kernels use a polynomial sin/cos accurate to a few ulp for |frequency * t|
+ * below about 1e9.
+ *
+ * @param soa Coefficients in SoA layout
+ * @param t Time parameter (0 to 2*PI)
+ * @param positions Output buffer, resized to soa.size() + 1
+ * @param kernel Kernel to use
+ */
+void evaluateEpicycles(const CoefficientSoA& soa, double t,
+                       std::vector<cv::Point2d>& positions,
+                       KernelType kernel = KernelType::Auto);
+
+/**
+ * @brief Compute all epicycle positions at time t with table trig
+ *
+ * Position error is bounded by table.positionErrorBound(soa, 1.0) in world
+ * units for |frequency * t| below about 1e9.
+ */
+void evaluateEpicycles(const CoefficientSoA& soa, double t,
+                       std::vector<cv::Point2d>& positions,
+                       const SineTable& table);
+
+} // namespace fourier
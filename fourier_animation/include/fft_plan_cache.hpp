@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <tuple>
+
+namespace fourier {
+
+/**
+ * @brief How to choose the FFT length for a given number of samples
+ */
+enum class FFTSizePolicy {
+    Exact,           // Transform exactly N samples
+    NextSmooth,      // Resample to the next 2,3,5-smooth length >= N
+    NextPowerOfTwo   // Resample to the next power of two >= N
+};
+
+/**
+ * @brief Plan cache hit/miss counters
+ */
+struct FFTPlanCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    size_t plans = 0;     // Plans currently cached
+};
+
+/**
+ * @brief Thread-safe cache of KissFFT plans keyed by size, direction and precision
+ *
+ * Building a plan computes twiddles and the factorisation; batch jobs
+ * transform many contours of the same length, so plans are built once and
+ * shared between threads.
+ */
+class FFTPlanCache {
+public:
+    /**
+     * @brief Process-wide cache
+     */
+    static FFTPlanCache& instance();
+    
+    FFTPlanCache();
+    ~FFTPlanCache();
+    
+    /**
+     * @brief Run an unnormalized FFT of length n using a cached plan
+     * @param in Input samples (n values)
+     * @param out Output bins (n values, must not alias in)
+     * @param n Transform length
+     * @param inverse false = forward (e^{-i}), true = inverse (e^{+i})
+     */
+    void transform(const std::complex<double>* in, std::complex<double>* out,
+                   size_t n, bool inverse = false);
+    void transform(const std::complex<float>* in, std::complex<float>* out,
+                   size_t n, bool inverse = false);
+    
+    FFTPlanCacheStats getStats() const;
+    
+    /**
+     * @brief Drop all cached plans and reset counters
+     */
+    void clear();
+
+private:
+    struct Plan;
+    using Key = std::tuple<size_t, bool, bool>;  // n, inverse, single precision
+    
+    std::shared_ptr<Plan> getPlan(size_t n, bool inverse, bool singlePrecision);
+    
+    mutable std::shared_mutex mutex;
+    std::map<Key, std::shared_ptr<Plan>> plans;
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+};
+
+/**
+ * @brief Smallest 2,3,5-smooth number >= n (fast KissFFT radices)
+ */
+size_t nextSmoothSize(size_t n);
+
+/**
+ * @brief Smallest power of two >= n
+ */
+size_t nextPowerOfTwo(size_t n);
+
+/**
+ * @brief FFT length to use for n samples under a size policy
+ */
+size_t chooseFFTSize(size_t n, FFTSizePolicy policy);
+
+} // namespace fourier
@@ -3,6 +3,7 @@
 #include <complex>
 #include <vector>
 #include <opencv2/core.hpp>
+#include "fft_plan_cache.hpp"
 
 namespace fourier {
 
@@ -14,10 +15,62 @@ struct FourierCoefficient {
     cv::Scalar color;
 };
 
-// Compute DFT and return coefficients sorted by amplitude
+struct DFTOptions {
+    // Prime or awkward N falls back to KissFFT's slow generic butterfly;
+    // NextSmooth / NextPowerOfTwo resample the closed contour to a fast size
+    FFTSizePolicy sizePolicy = FFTSizePolicy::Exact;
+    bool singlePrecision = false;  // Transform in float instead of double
+};
+
+// Compute DFT and return the numCircles largest coefficients sorted by
+// amplitude (all of them if numCircles <= 0). Colors are assigned in rank
+// order, so they are deterministic and stable across numCircles. FFT plans
+// come from FFTPlanCache::instance().
 std::vector<FourierCoefficient> computeDFT(
     const std::vector<std::complex<double>>& points,
-    int numCircles
+    int numCircles,
+    const DFTOptions& options = DFTOptions()
+);
+
+// Give coefficients (sorted by amplitude) the colors computeDFT assigns:
+// random, drawn in rank order from a fixed seed. Used for coefficients
+// that were not produced by computeDFT, e.g. loaded from a file.
+void assignColors(std::vector<FourierCoefficient>& coefficients);
+
+// Split a budget of totalCircles terms among several spectra (computeDFT
+// output, same units) by energy: after each shape gets
+// min(minPerShape, totalCircles / shapes) terms, the rest go to the
+// largest remaining amplitudes across all shapes, which minimizes the total
+// squared error of the truncation. Returns the term count per shape
+// (everything if totalCircles <= 0).
+std::vector<int> allocateCircles(
+    const std::vector<std::vector<FourierCoefficient>>& spectra,
+    int totalCircles,
+    int minPerShape = 2
+);
+
+// computeDFT of several shapes in parallel, truncated to an energy-based
+// split of totalCircles (see allocateCircles). Shapes must share one
+// normalization so their amplitudes compare.
+std::vector<std::vector<FourierCoefficient>> computeDFTs(
+    const std::vector<std::vector<std::complex<double>>>& shapes,
+    int totalCircles,
+    const DFTOptions& options = DFTOptions()
+);
+
+// Truncate full spectra (computeDFT output) in place to the allocateCircles
+// split of totalCircles; what computeDFTs does after transforming
+void truncateSpectra(std::vector<std::vector<FourierCoefficient>>& spectra, int totalCircles);
+
+// Exponential smoothing for a shape that changes over time: every
+// coefficient of `latest` is blended with the one of the same frequency in
+// `smoothed` (alpha = weight of latest; frequencies new to latest fade in
+// from zero, ones it dropped disappear). The result replaces `smoothed`,
+// sorted by amplitude with rank-order colors like computeDFT output.
+void smoothCoefficients(
+    std::vector<FourierCoefficient>& smoothed,
+    const std::vector<FourierCoefficient>& latest,
+    double alpha
 );
 
 // Get epicycle positions at time t
@@ -26,4 +79,64 @@ std::vector<cv::Point2d> getEpicyclePositions(
     double t
 );
 
+// Same, into a caller-owned buffer (no allocation once it has grown)
+void getEpicyclePositions(
+    const std::vector<FourierCoefficient>& coefficients,
+    double t,
+    std::vector<cv::Point2d>& positions
+);
+
+// Evaluate the truncated series at `samples` evenly spaced t in [0, 2*pi)
+// with one inverse FFT. Frequencies are reduced modulo samples, so samples
+// must exceed 2 * max |frequency| to avoid aliasing.
+std::vector<std::complex<double>> sampleTrajectory(
+    const std::vector<FourierCoefficient>& coefficients,
+    int samples
+);
+
+// Same, into caller-owned buffers (spectrum is scratch); no allocation once
+// they have grown, so repeated refits of the same length reuse them
+void sampleTrajectory(
+    const std::vector<FourierCoefficient>& coefficients,
+    int samples,
+    std::vector<std::complex<double>>& spectrum,
+    std::vector<std::complex<double>>& trajectory
+);
+
+// Stateful epicycle evaluator for frames spaced 2*pi/totalFrames apart.
+// Each coefficient's rotation is advanced by multiplying with a precomputed
+// step phasor instead of calling cos/sin; rotations are recomputed exactly
+// every resyncInterval steps so rounding drift stays bounded.
+class EpicycleEvaluator {
+public:
+    EpicycleEvaluator() = default;
+    EpicycleEvaluator(const std::vector<FourierCoefficient>& coefficients,
+                      int totalFrames, int resyncInterval = 256);
+
+    void reset(const std::vector<FourierCoefficient>& coefficients,
+               int totalFrames, int resyncInterval = 256);
+
+    // Write the positions of frame frameIndex into a caller-owned buffer
+    // (resized to coefficients + 1, same layout as getEpicyclePositions).
+    // Cheapest when frameIndex advances by a constant stride between calls.
+    void evaluate(int frameIndex, std::vector<cv::Point2d>& positions);
+
+    size_t size() const { return frequencies.size(); }
+
+private:
+    void seek(int frameIndex);
+    void setStride(int frames);
+
+    std::vector<double> frequencies;
+    std::vector<double> amplitudes;
+    std::vector<double> phases;
+    std::vector<double> termRe, termIm;  // amplitude * e^{i(frequency * t + phase)}
+    std::vector<double> stepRe, stepIm;  // e^{i * frequency * 2*pi * stride / totalFrames}
+    int totalFrames = 1;
+    int resyncInterval = 256;
+    int currentFrame = -1;
+    int stride = 0;
+    int stepsSinceResync = 0;
+};
+
 }
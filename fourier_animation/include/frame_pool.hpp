@@ -0,0 +1,72 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace fourier {
+
+/**
+ * @brief Frame pool usage counters
+ */
+struct FramePoolStats {
+    int capacity = 0;
+    int allocated = 0;        // Pooled buffers created so far (<= capacity)
+    size_t acquired = 0;      // acquire() calls
+    size_t overflows = 0;     // acquire() calls served by a one-off allocation
+};
+
+/**
+ * @brief Fixed-capacity pool of equally sized frame buffers
+ *
+ * acquire() hands out a cv::Mat sharing a pooled buffer. The buffer goes back
+ * to the pool when every other reference is released (e.g. once the video
+ * writer has encoded the frame), so there is no explicit return call and
+ * frames can travel through the existing cv::Mat APIs. Buffers are created
+ * lazily up to the capacity; if all of them are still in use, a one-off
+ * frame is allocated and counted as an overflow.
+ *
+ * acquire() must be called from a single thread; frames may be released
+ * from any thread.
+ */
+class FramePool {
+public:
+    explicit FramePool(int capacity = 12);
+    
+    /**
+     * @brief Set the frame geometry and drop buffers of a different shape
+     */
+    void reset(cv::Size size, int type);
+    
+    /**
+     * @brief Set the number of pooled buffers (existing ones are kept)
+     */
+    void setCapacity(int capacity);
+    
+    /**
+     * @brief Get a frame not referenced by anyone else
+     * 
+     * A reused buffer still holds what was last drawn into it, which lets
+     * the caller update only what changed.
+     * 
+     * @param slot If given, receives the buffer's index in [0, capacity),
+     *             or -1 for an overflow frame (contents undefined)
+     */
+    cv::Mat acquire(int* slot = nullptr);
+    
+    FramePoolStats getStats() const;
+    cv::Size size() const { return frameSize; }
+    int type() const { return frameType; }
+
+private:
+    static bool isFree(const cv::Mat& buffer);
+    
+    std::vector<cv::Mat> buffers;
+    cv::Size frameSize;
+    int frameType = 0;
+    int capacity;
+    size_t nextSlot = 0;  // Round-robin start of the free-buffer scan
+    FramePoolStats stats;
+};
+
+} // namespace fourier
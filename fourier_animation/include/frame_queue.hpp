@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace fourier {
+
+/**
+ * @brief Bounded lock-free single-producer / single-consumer ring buffer
+ *
+ * tryPush/tryPop never block. waitForSpace/waitForItem block on C++20 atomic
+ * waits (futex based) instead of a mutex, so an uncontended push or pop is a
+ * couple of atomic operations.
+ */
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity)
+        : slots(capacity > 0 ? capacity : 1) {}
+    
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+    
+    /**
+     * @brief Move an item into the ring (producer only)
+     * @return false if the ring is full
+     */
+    bool tryPush(T&& item) {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) >= slots.size()) {
+            return false;
+        }
+        slots[t % slots.size()] = std::move(item);
+        tail.store(t + 1, std::memory_order_release);
+        
+        signal.fetch_add(1, std::memory_order_release);
+        signal.notify_one();
+        return true;
+    }
+    
+    /**
+     * @brief Move the oldest item out of the ring (consumer only)
+     * @return false if the ring is empty
+     */
+    bool tryPop(T& item) {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = std::move(slots[h % slots.size()]);
+        head.store(h + 1, std::memory_order_release);
+        head.notify_one();
+        return true;
+    }
+    
+    /**
+     * @brief Block until the ring has a free slot (producer only)
+     */
+    void waitForSpace() const {
+        size_t h = head.load(std::memory_order_acquire);
+        while (tail.load(std::memory_order_relaxed) - h >= slots.size()) {
+            head.wait(h, std::memory_order_acquire);
+            h = head.load(std::memory_order_acquire);
+        }
+    }
+    
+    /**
+     * @brief Block until an item is available or the ring is closed (consumer only)
+     * @return false if the ring is closed and drained
+     */
+    bool waitForItem() const {
+        while (true) {
+            const uint32_t observed = signal.load(std::memory_order_acquire);
+            if (head.load(std::memory_order_relaxed) != tail.load(std::memory_order_acquire)) {
+                return true;
+            }
+            if (closed.load(std::memory_order_acquire)) {
+                return false;
+            }
+            signal.wait(observed, std::memory_order_acquire);
+        }
+    }
+    
+    /**
+     * @brief Wake the consumer and make waitForItem return false once drained
+     */
+    void close() {
+        closed.store(true, std::memory_order_release);
+        signal.fetch_add(1, std::memory_order_release);
+        signal.notify_all();
+    }
+    
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+    
+    size_t capacity() const {
+        return slots.size();
+    }
+
+private:
+    std::vector<T> slots;
+    alignas(64) std::atomic<size_t> head{0};      // Next slot to pop (consumer)
+    alignas(64) std::atomic<size_t> tail{0};      // Next slot to push (producer)
+    alignas(64) std::atomic<uint32_t> signal{0};  // Bumped on push/close to wake the consumer
+    std::atomic<bool> closed{false};
+};
+
+} // namespace fourier
@@ -0,0 +1,239 @@
+#pragma once
+
+#include "video_writer.hpp"
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fourier {
+
+/**
+ * @brief Destination of the frames handed over by VideoWriter
+ *
+ * Frames arrive as BGR images at the configured size, on one thread
+ * (the encode thread in async mode). A sink may keep the frame's pixel
+ * data only until write() returns.
+ */
+class FrameSink {
+public:
+    virtual ~FrameSink() = default;
+    
+    /**
+     * @brief Prepare the output
+     * @return true if frames can be written
+     */
+    virtual bool open(const VideoConfig& config) = 0;
+    
+    /**
+     * @brief Write a frame shown for `repeats` frame periods
+     * @return false once the output failed (e.g. the reading process exited)
+     */
+    virtual bool write(const cv::Mat& frame, int repeats) = 0;
+    
+    /**
+     * @brief Flush and close the output
+     */
+    virtual void close() = 0;
+    
+    virtual const char* name() const = 0;
+};
+
+/**
+ * @brief Encoded video through cv::VideoWriter (GStreamer/NVENC on Jetson,
+ *        else FFmpeg with codec fallbacks)
+ *
+ * cv::VideoWriter has no frame duration. For MP4/MOV/MKV outputs with
+ * ffmpeg on the PATH, the video is therefore written as segment files
+ * (<stem>.segNNN<extension>): a held frame is encoded once, as a segment
+ * of its own, and close() joins the segments with the concat demuxer,
+ * giving each hold segment its hold duration (stream copy, nothing is
+ * encoded again). Otherwise a held frame is encoded once per repeat.
+ */
+class ContainerSink : public FrameSink {
+public:
+    bool open(const VideoConfig& config) override;
+    bool write(const cv::Mat& frame, int repeats) override;
+    void close() override;
+    const char* name() const override { return "container"; }
+
+private:
+    struct Segment {
+        std::string path;
+        int holdFrames = 0;  // > 0: a single frame shown for this many periods
+    };
+    
+    bool openWriter(cv::VideoWriter& target, const std::string& path);
+    bool writeHold(const cv::Mat& frame, int repeats);
+    void closeSegment();
+    std::string segmentPath(size_t index) const;
+    
+    VideoConfig config;
+    cv::VideoWriter writer;
+    bool gstreamer = false;        // Backend and codec picked by open(), reused per segment
+    int fourcc = 0;
+    bool segmented = false;        // Holds become one-frame segments
+    std::vector<Segment> segments;
+    int segmentFrames = 0;         // Frames in the segment `writer` is writing
+};
+
+/**
+ * @brief Uncompressed frames for an external encoder: raw BGR, raw I420 or Y4M
+ *
+ * Writes to a file, a FIFO or stdout ("-") through one large stdio buffer,
+ * so each frame goes out in a few big writes. I420 is converted with
+ * cv::cvtColor (SIMD) into a buffer allocated at open(); a held frame is
+ * converted once and its bytes written again. Nothing is allocated per
+ * frame. For stdout, log output must not go to stdout as well (main
+ * redirects std::cout to stderr).
+ */
+class RawStreamSink : public FrameSink {
+public:
+    explicit RawStreamSink(OutputFormat format);
+    ~RawStreamSink() override;
+    
+    bool open(const VideoConfig& config) override;
+    bool write(const cv::Mat& frame, int repeats) override;
+    void close() override;
+    const char* name() const override;
+    
+    /**
+     * @brief Y4M stream header for a configuration
+     * 
+     * 4:2:0 in BT.601 limited range, which is what cv::cvtColor produces.
+     */
+    static std::string y4mHeader(const VideoConfig& config);
+
+private:
+    bool writeBytes(const void* data, size_t size);
+    
+    OutputFormat format;
+    std::FILE* file = nullptr;
+    std::vector<char> buffer;  // stdio buffer
+    cv::Mat i420;              // Converted frame (I420 and Y4M)
+    cv::Mat staging;           // Continuous copy of a non-continuous BGR frame
+    bool failed = false;
+};
+
+/**
+ * @brief One image file per frame (PNG or QOI), compressed on a thread pool
+ *
+ * write() copies the frame into one of sequenceInFlight preallocated
+ * buffers and returns; workers compress and write the files, so memory
+ * stays bounded and write() only blocks while every buffer is in use. A
+ * held frame is compressed once and written under each of its indices.
+ *
+ * With sequenceCropChanges each file holds only the bounding box of the
+ * pixels that differ from the previous frame (the first frame in full;
+ * none for an unchanged frame), and close() writes manifest.json next to
+ * the images with every frame's file and rectangle, for compositing.
+ */
+class ImageSequenceSink : public FrameSink {
+public:
+    explicit ImageSequenceSink(OutputFormat format);
+    ~ImageSequenceSink() override;
+    
+    bool open(const VideoConfig& config) override;
+    bool write(const cv::Mat& frame, int repeats) override;
+    void close() override;
+    const char* name() const override;
+    
+    /**
+     * @brief File name for a frame: the pattern's %d (or %0Nd) replaced by index
+     * @return Empty if the pattern has no such conversion
+     */
+    static std::string fileName(const std::string& pattern, int index);
+    
+    /**
+     * @brief Encode a BGR image as QOI (RGB, sRGB)
+     * @param image 8-bit BGR image (may be a view)
+     * @param out Encoded bytes (replaced; keeps its capacity)
+     */
+    static void encodeQoi(const cv::Mat& image, std::vector<uint8_t>& out);
+
+private:
+    struct Job {
+        int slot;
+        int firstIndex;
+        int repeats;
+        cv::Rect rect;      // Region of the frame held in the slot (at its origin)
+    };
+    struct ManifestEntry {
+        int index;
+        cv::Rect rect;      // Empty: unchanged, no file
+    };
+    
+    void workerLoop();
+    bool compress(const cv::Mat& image, std::vector<uint8_t>& out) const;
+    void writeManifest() const;
+    
+    OutputFormat format;
+    VideoConfig config;
+    
+    std::vector<std::thread> workers;
+    std::vector<cv::Mat> slots;         // Frame buffers, full frame size
+    std::vector<int> freeSlots;
+    std::deque<Job> jobs;
+    std::mutex mutex;
+    std::condition_variable jobReady;
+    std::condition_variable slotFree;
+    bool stopping = false;
+    std::atomic<bool> failed{false};
+    
+    // Change detection (calling thread only)
+    cv::Mat previous;
+    cv::Mat difference;
+    int nextIndex = 0;
+    std::vector<ManifestEntry> manifest;
+};
+
+/**
+ * @brief Output format for a configuration (Auto resolved from outputPath)
+ *
+ * "-" and .y4m stream Y4M, .yuv raw I420, .bgr/.raw raw BGR; a path with a
+ * %d pattern is a PNG sequence (QOI for .qoi); anything else is an encoded
+ * container.
+ */
+OutputFormat resolveOutputFormat(const VideoConfig& config);
+
+/**
+ * @brief True for the one-file-per-frame formats
+ */
+bool isImageSequence(OutputFormat format);
+
+/**
+ * @brief File extension (with dot) for outputs of a format
+ */
+std::string outputExtension(OutputFormat format);
+
+/**
+ * @brief Create the sink for a configuration's (resolved) format
+ */
+std::unique_ptr<FrameSink> createFrameSink(const VideoConfig& config);
+
+/**
+ * @brief Input of concatenateContainers
+ */
+struct ConcatEntry {
+    std::string path;
+    double seconds = 0.0;  // Shown for this long (ffconcat duration); 0: the file's own length
+};
+
+/**
+ * @brief Join container files with ffmpeg's concat demuxer, stream copy
+ *
+ * The files must be separate encodes with one codec and frame size.
+ * Needs ffmpeg on the PATH.
+ */
+bool concatenateContainers(const std::vector<ConcatEntry>& entries, const std::string& outputPath,
+                           std::string* errorMessage = nullptr);
+
+} // namespace fourier
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "fourier.hpp"
+#include "contour_extractor.hpp"
+#include "animation.hpp"
+#include "video_writer.hpp"
+#include "shape_tracker.hpp"
+#include <opencv2/videoio.hpp>
+#include <memory>
+#include <string>
+
+namespace fourier {
+
+/**
+ * @brief Live input configuration
+ */
+struct LiveConfig {
+    std::string source;             // Video file, stream URL or camera index ("0")
+    int maxFrames = 0;              // Input frames to process (0 = until the source ends)
+    double latencyBudgetMs = 50.0;  // Capture-to-output target per frame
+    bool record = true;             // Encode to VideoConfig::outputPath
+    bool display = false;           // Show frames in a window ('q' or Esc stops)
+    
+    // Draw on top of the input, with the epicycles placed on the shape
+    // they trace; otherwise the shape is centered like an image render
+    bool overlay = true;
+    double overlayOpacity = 0.5;    // Weight of the input frame added under the drawing
+    
+    // ROI search, FFT skipping and coefficient smoothing between frames
+    // (disabled: every frame is processed from scratch)
+    TrackerConfig tracking;
+};
+
+/**
+ * @brief Outcome of a live run (latency: frame read to frame output)
+ */
+struct LiveStats {
+    bool success = false;
+    std::string errorMessage;
+    int framesIn = 0;
+    int framesOut = 0;
+    int shapeUpdates = 0;       // Frames that changed the drawn shape
+    int overBudget = 0;         // Frames slower than the latency budget
+    TrackerStats tracking;      // Searches, transforms and reuse
+    double p50LatencyMs = 0.0;
+    double p95LatencyMs = 0.0;
+    double maxLatencyMs = 0.0;
+    double wallSeconds = 0.0;
+    
+    double framesPerSecond() const {
+        return wallSeconds > 0.0 ? framesOut / wallSeconds : 0.0;
+    }
+};
+
+/**
+ * @brief Epicycles of the largest contour of every frame of a video or camera
+ *
+ * Each input frame is scaled to the output resolution and handed to a
+ * ShapeTracker, and one animation frame is rendered with its coefficients,
+ * so the epicycles keep turning while the shape follows the input. A frame
+ * that misses the latency budget makes the next one keep the previous
+ * coefficients and only render, so a slow stage costs one stale shape
+ * rather than a growing backlog. Frames without a contour also keep the
+ * previous shape.
+ */
+class LivePipeline {
+public:
+    LivePipeline(const LiveConfig& liveConfig,
+                 const ContourConfig& contourConfig,
+                 const AnimationConfig& animConfig,
+                 const VideoConfig& videoConfig,
+                 const DFTOptions& dftOptions = DFTOptions());
+    ~LivePipeline();
+    
+    /**
+     * @brief Process the source until it ends, maxFrames or a stop key
+     * @return Statistics; success is false if the source or writer failed to open
+     */
+    LiveStats run();
+    
+    /**
+     * @brief Open a capture: a camera for an all-digit source, else a file or URL
+     * @return true if the capture is open
+     */
+    static bool openSource(cv::VideoCapture& capture, const std::string& source);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+} // namespace fourier
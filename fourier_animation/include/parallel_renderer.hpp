@@ -0,0 +1,89 @@
+#pragma once
+
+#include "animation.hpp"
+#include <opencv2/core.hpp>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace fourier {
+
+/**
+ * @brief Timing summary of a parallel render
+ */
+struct ParallelRenderStats {
+    int threads = 0;
+    int frames = 0;
+    double wallSeconds = 0.0;    // Elapsed time of the whole render
+    double renderSeconds = 0.0;  // Sum of time workers spent inside renderFrame
+    
+    /**
+     * @brief Fraction of the workers' wall time spent inside renderFrame
+     *
+     * Not a speedup over one thread: frames render slower under contention
+     * (shared memory bandwidth, SMT), which this ratio does not see.
+     */
+    double utilization() const {
+        return (wallSeconds > 0.0 && threads > 0) ? renderSeconds / (wallSeconds * threads) : 0.0;
+    }
+};
+
+/**
+ * @brief Renders animation frames on several threads and delivers them in order
+ *
+ * Each worker owns its own AnimationEngine (and Cairo surface) and renders
+ * frame indices out of order; a reorder buffer hands finished frames to the
+ * caller strictly in sequence, e.g. to feed a VideoWriter.
+ */
+class ParallelRenderer {
+public:
+    using FrameCallback = std::function<void(int frameIndex, const cv::Mat& frame)>;
+    
+    /**
+     * @param numThreads Number of worker threads (at least 1)
+     */
+    explicit ParallelRenderer(int numThreads);
+    ~ParallelRenderer();
+    
+    /**
+     * @brief Initialize one animation engine per worker
+     * @param coefficients Fourier coefficients from DFT
+     * @param config Animation configuration
+     */
+    void initialize(const std::vector<FourierCoefficient>& coefficients,
+                    const AnimationConfig& config = AnimationConfig());
+    
+    /**
+     * @brief Initialize one multi-chain engine per worker
+     * @param chains Fourier coefficients of each shape
+     * @param config Animation configuration
+     */
+    void initialize(const std::vector<std::vector<FourierCoefficient>>& chains,
+                    const AnimationConfig& config = AnimationConfig());
+    
+    /**
+     * @brief Render frames, calling onFrame for each one in frame order
+     *
+     * onFrame runs on the calling thread. Failed frames are delivered as an
+     * empty Mat. A range that starts past frame 0 does not render the
+     * frames before it (engines rebuild the traced path directly).
+     *
+     * @param onFrame Consumer of rendered frames
+     * @param firstFrame First frame to render
+     * @param endFrame One past the last frame (-1: config.totalFrames)
+     * @return Timing summary
+     */
+    ParallelRenderStats render(const FrameCallback& onFrame, int firstFrame = 0, int endFrame = -1);
+    
+    /**
+     * @brief Number of worker threads
+     */
+    int getThreadCount() const;
+
+private:
+    int numThreads;
+    AnimationConfig config;
+    std::vector<std::unique_ptr<AnimationEngine>> engines;
+};
+
+} // namespace fourier
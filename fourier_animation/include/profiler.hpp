@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace fourier {
+
+/**
+ * @brief Per-stage timing statistics
+ */
+struct StageSummary {
+    std::string name;
+    size_t count = 0;
+    double totalMs = 0.0;
+    double p50Us = 0.0;
+    double p95Us = 0.0;
+    double p99Us = 0.0;
+    double maxUs = 0.0;
+};
+
+/**
+ * @brief Collects scoped stage timings from any thread
+ *
+ * Events go to a per-thread buffer without locking. Recording is off until
+ * setEnabled(true); with FOURIER_PROFILING undefined the FOURIER_PROFILE_SCOPE
+ * macro compiles to nothing. Summaries and traces must be written after the
+ * measured work has finished.
+ */
+class Profiler {
+public:
+    static Profiler& instance();
+    
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+    
+    /**
+     * @brief Get the id of a named stage (registers it on first use)
+     */
+    uint32_t registerStage(const char* name);
+    
+    /**
+     * @brief Record one timed interval for a stage on the calling thread
+     */
+    void record(uint32_t stage, int64_t startNs, int64_t durationNs);
+    
+    /**
+     * @brief p50/p95/p99 per stage, in registration order
+     */
+    std::vector<StageSummary> summarize() const;
+    
+    /**
+     * @brief Write stage summaries as JSON
+     */
+    bool writeJson(const std::string& path) const;
+    
+    /**
+     * @brief Write every recorded interval in Chrome trace-event format
+     *        (load in chrome://tracing or Perfetto)
+     */
+    bool writeChromeTrace(const std::string& path) const;
+    
+    /**
+     * @brief Discard recorded events (stage ids stay valid)
+     */
+    void clear();
+    
+    static int64_t nowNs();
+
+private:
+    struct Event {
+        uint32_t stage;
+        int64_t startNs;
+        int64_t durationNs;
+    };
+    
+    struct ThreadBuffer {
+        uint32_t threadId = 0;
+        std::vector<Event> events;
+    };
+    
+    Profiler() = default;
+    ThreadBuffer& localBuffer();
+    
+    std::atomic<bool> enabled{false};
+    mutable std::mutex mutex;  // Guards stageNames and buffers (not events)
+    std::vector<std::string> stageNames;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+};
+
+/**
+ * @brief RAII timer recording its lifetime under a stage id
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(uint32_t stage)
+        : stage(stage),
+          startNs(Profiler::instance().isEnabled() ? Profiler::nowNs() : -1) {}
+    
+    ~ScopedTimer() {
+        if (startNs >= 0) {
+            Profiler::instance().record(stage, startNs, Profiler::nowNs() - startNs);
+        }
+    }
+    
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    uint32_t stage;
+    int64_t startNs;
+};
+
+} // namespace fourier
+
+#define FOURIER_PROFILE_CONCAT_INNER(a, b) a##b
+#define FOURIER_PROFILE_CONCAT(a, b) FOURIER_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef FOURIER_PROFILING
+// Time the rest of the enclosing scope as stage `name` (a string literal)
+#define FOURIER_PROFILE_SCOPE(name) \
+    static const uint32_t FOURIER_PROFILE_CONCAT(profileStage_, __LINE__) = \
+        ::fourier::Profiler::instance().registerStage(name); \
+    ::fourier::ScopedTimer FOURIER_PROFILE_CONCAT(profileTimer_, __LINE__)( \
+        FOURIER_PROFILE_CONCAT(profileStage_, __LINE__))
+#else
+#define FOURIER_PROFILE_SCOPE(name) ((void)0)
+#endif
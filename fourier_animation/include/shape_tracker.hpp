@@ -0,0 +1,97 @@
+#pragma once
+
+#include "fourier.hpp"
+#include "contour_extractor.hpp"
+#include <opencv2/core.hpp>
+#include <vector>
+
+namespace fourier {
+
+/**
+ * @brief Temporal reuse settings for video input
+ */
+struct TrackerConfig {
+    // Off: every frame is searched in full and transformed from scratch
+    bool enabled = true;
+    double roiMargin = 0.25;        // ROI padding around the last contour, fraction of its size
+    int fullSearchInterval = 30;    // Frames between full-frame searches (finds new, larger shapes)
+    double reuseThreshold = 1.0;    // RMS sample motion (pixels) below which the FFT is skipped
+    double smoothing = 0.5;         // Weight of the newest coefficients (1 = no smoothing)
+};
+
+/**
+ * @brief Tracker work counters
+ */
+struct TrackerStats {
+    int frames = 0;
+    int fullSearches = 0;
+    int roiSearches = 0;
+    int transforms = 0;     // Frames whose coefficients were recomputed
+    int reused = 0;         // Frames that kept the coefficients (FFT skipped)
+    int lost = 0;           // Frames without a contour
+};
+
+/**
+ * @brief Result of ShapeTracker::update
+ */
+enum class TrackUpdate {
+    None,     // No contour found; the previous shape is kept
+    Reused,   // Contour barely moved; coefficients unchanged
+    Updated   // New (smoothed) coefficients, center and scale
+};
+
+/**
+ * @brief Follows the largest contour through a video, reusing work between frames
+ *
+ * After the first full-frame search the contour is searched only inside a
+ * padded ROI around its last bounds; a contour reaching the ROI edge, a
+ * lost one or every fullSearchInterval frames trigger a full search. If
+ * the sampled points moved less than reuseThreshold pixels (RMS) since the
+ * coefficients were computed, the FFT is skipped. Otherwise the new
+ * coefficients, center and scale are smoothed exponentially so the
+ * epicycles do not jitter. Coefficients are normalized like computeDFT
+ * output: the shape on screen is center + scale * sum(c_k e^{i k t}).
+ */
+class ShapeTracker {
+public:
+    ShapeTracker(const TrackerConfig& config,
+                 const ContourConfig& contourConfig,
+                 int numCircles,
+                 const DFTOptions& dftOptions = DFTOptions());
+    
+    /**
+     * @brief Process one frame
+     * @param frame Input image (grayscale or BGR)
+     * @return What changed
+     */
+    TrackUpdate update(const cv::Mat& frame);
+    
+    /**
+     * @brief Forget the tracked shape (next update searches the full frame)
+     */
+    void reset();
+    
+    bool hasShape() const { return tracking; }
+    const std::vector<FourierCoefficient>& getCoefficients() const { return coefficients; }
+    cv::Point2d getCenter() const { return center; }
+    double getScale() const { return scale; }
+    TrackerStats getStats() const { return stats; }
+
+private:
+    TrackerConfig config;
+    int numCircles;
+    DFTOptions dftOptions;
+    ContourExtractor extractor;
+    
+    bool tracking = false;
+    cv::Rect bounds;                     // Last contour's bounding box
+    int framesSinceFullSearch = 0;
+    std::vector<cv::Point2d> reference;  // Sampled points behind `coefficients` (pixels)
+    std::vector<cv::Point2d> samples;    // Current frame's sampled points (pixels)
+    std::vector<FourierCoefficient> coefficients;
+    cv::Point2d center;
+    double scale = 1.0;                  // Pixels per coefficient unit
+    TrackerStats stats;
+};
+
+} // namespace fourier
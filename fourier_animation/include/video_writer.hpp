@@ -2,10 +2,27 @@
 
 #include <opencv2/core.hpp>
 #include <opencv2/videoio.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
 #include <string>
 
 namespace fourier {
 
+/**
+ * @brief What VideoWriter produces (see resolveOutputFormat)
+ */
+enum class OutputFormat {
+    Auto,         // From outputPath: "-", .y4m, .yuv, .bgr/.raw, %d patterns, else Container
+    Container,    // Encoded video through cv::VideoWriter
+    RawBGR,       // Packed BGR24 frames, no header
+    RawI420,      // Planar YUV 4:2:0 frames, no header
+    Y4M,          // YUV4MPEG2 stream (I420 with a header, e.g. for ffmpeg -i -)
+    PngSequence,  // One PNG per frame; outputPath is a pattern (frames/frame_%06d.png)
+    QoiSequence   // One QOI per frame (lossless, much cheaper to compress than PNG)
+};
+
 /**
  * @brief Video output configuration
  */
@@ -14,12 +31,65 @@ struct VideoConfig {
     int height = 1080;          // Video height
     double fps = 60.0;          // Frames per second
     std::string codec = "avc1"; // Codec (H.264)
-    std::string outputPath = "output.mp4";
+    std::string outputPath = "output.mp4";  // "-" streams to stdout
     bool useHardwareEncoding = true;  // Use NVENC on Jetson
+    
+    // Raw and Y4M output for an external encoder (file, FIFO or stdout)
+    OutputFormat format = OutputFormat::Auto;
+    size_t streamBufferBytes = 8 << 20;  // stdio buffer of raw/Y4M sinks
+    
+    // Image sequences: frames are compressed on a thread pool
+    int sequenceThreads = 0;            // Compression threads (0 = one per core)
+    int sequenceInFlight = 0;           // Frames buffered for compression (0 = 2 per thread)
+    bool sequenceCropChanges = false;   // Write only the changed bounding box, plus manifest.json
+    int pngCompression = 1;             // zlib level 0-9 (1: fastest deflate)
+    int firstFileIndex = 0;             // Number of the first file (frame-range chunks)
+    
+    // Frames between keyframes (0: one per second). Chunks of a sharded
+    // render start on this cadence, so concatenated chunks keep the GOP
+    // structure of a single encode. Reaches NVENC through the GStreamer
+    // pipeline; for FFmpeg, main sets OPENCV_FFMPEG_WRITER_OPTIONS on
+    // sharded renders only (other renders keep the codec's defaults).
+    int keyframeInterval = 0;
+    
+    // Asynchronous encoding: writeFrame only queues the frame and a dedicated
+    // thread resizes and encodes it, overlapping encoding with rendering
+    bool asyncEncoding = false;
+    int queueDepth = 8;         // Frames buffered between render and encode threads
+    
+    // Stills around the animation (see VideoWriter::writeHold)
+    double introHoldSeconds = 0.0;  // First frame shown before drawing starts
+    double endHoldSeconds = 2.0;    // Finished drawing shown at the end
+    
+    int holdFrames(double seconds) const {
+        return std::max(0, static_cast<int>(fps * seconds));
+    }
+    
+    // Output position of an animation frame (where frame 0 first appears:
+    // the start of the intro hold)
+    int outputIndex(int frame) const {
+        return frame == 0 ? 0 : frame + holdFrames(introHoldSeconds);
+    }
+    
+    int keyframeFrames() const {
+        return keyframeInterval > 0 ? keyframeInterval : std::max(1, static_cast<int>(std::lround(fps)));
+    }
 };
 
 /**
- * @brief Video writer wrapper with FFmpeg/GStreamer support
+ * @brief Encoder throughput and back-pressure statistics
+ */
+struct VideoWriterStats {
+    int framesEncoded = 0;
+    int queueHighWater = 0;     // Most frames waiting in the queue at once
+    double stallSeconds = 0.0;  // Time writeFrame blocked on a full queue
+    double encodeSeconds = 0.0; // Time spent resizing and encoding
+    int heldFrames = 0;         // Frames of writeHold segments (prepared once each)
+};
+
+/**
+ * @brief Video writer: resizing, async encode queue and holds in front of a
+ *        FrameSink (encoded container, or raw/Y4M frames for a pipe)
  */
 class VideoWriter {
 public:
@@ -35,10 +105,32 @@ public:
     
     /**
      * @brief Write a frame to the video
+     * 
+     * In async mode the frame is queued (sharing its pixel data, so it must
+     * not be modified afterwards) and this blocks only while the queue is
+     * full. writeFrame must be called from a single thread. The writer
+     * drops its reference as soon as the frame is encoded, which returns
+     * pooled frames (see FramePool) for reuse.
+     * 
      * @param frame BGR image frame
      * @return true if successful
      */
     bool writeFrame(const cv::Mat& frame);
+    bool writeFrame(cv::Mat&& frame);
+    
+    /**
+     * @brief Show one frame for several frame periods (intro or end still)
+     * 
+     * The frame is queued and resized once and handed to the sink once
+     * with its count, so a hold costs no rendering, copies or queue slots
+     * beyond the first frame. Containers encode it once where they can
+     * (see ContainerSink). Same sharing rules as writeFrame.
+     * 
+     * @param frame BGR image frame
+     * @param count Frame periods to show it for (nothing if <= 0)
+     * @return true if successful
+     */
+    bool writeHold(const cv::Mat& frame, int count);
     
     /**
      * @brief Close and finalize the video
@@ -55,6 +147,11 @@ public:
      */
     int getFrameCount() const;
     
+    /**
+     * @brief Get encoder statistics (final once release() has returned)
+     */
+    VideoWriterStats getStats() const;
+    
     /**
      * @brief Get GStreamer pipeline string for Jetson hardware encoding
      * @param config Video configuration
@@ -1,4 +1,8 @@
 #include "animation.hpp"
+#include "profiler.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <numbers>
 #include <iostream>
 
@@ -10,48 +14,385 @@ namespace fourier {
 
 constexpr double TWO_PI = 2.0 * std::numbers::pi;
 
+namespace {
+
+// Bounding union that treats an empty rect as "nothing"
+cv::Rect unite(const cv::Rect& a, const cv::Rect& b) {
+    if (a.empty()) return b;
+    if (b.empty()) return a;
+    return a | b;
+}
+
+// Bounds of path points [first, end), padded for stroke width and antialiasing
+cv::Rect segmentBounds(std::span<const cv::Point2d> path, size_t first, int thickness) {
+    double minX = path[first].x, maxX = minX;
+    double minY = path[first].y, maxY = minY;
+    for (size_t i = first + 1; i < path.size(); ++i) {
+        minX = std::min(minX, path[i].x);
+        maxX = std::max(maxX, path[i].x);
+        minY = std::min(minY, path[i].y);
+        maxY = std::max(maxY, path[i].y);
+    }
+    int pad = thickness + 2;
+    int x0 = static_cast<int>(std::floor(minX)) - pad;
+    int y0 = static_cast<int>(std::floor(minY)) - pad;
+    int x1 = static_cast<int>(std::ceil(maxX)) + pad;
+    int y1 = static_cast<int>(std::ceil(maxY)) + pad;
+    return cv::Rect(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
+}
+
+// Sub-pixel path points go to cv::line as fixed point with PATH_SHIFT bits
+constexpr int PATH_SHIFT = 4;
+
+cv::Point toFixedPoint(const cv::Point2d& p) {
+    constexpr double one = 1 << PATH_SHIFT;
+    return cv::Point(static_cast<int>(std::lround(p.x * one)),
+                     static_cast<int>(std::lround(p.y * one)));
+}
+
+// Pen outline: a radius 6 ring as a closed polyline. cv::circle with
+// thickness 2 draws through EllipseEx, which allocates on every call;
+// thick LINE_8 segments (like the path's) do not.
+constexpr int PEN_OUTLINE_POINTS = 24;
+
+std::array<cv::Point, PEN_OUTLINE_POINTS> penOutlineRing() {
+    std::array<cv::Point, PEN_OUTLINE_POINTS> ring;
+    for (int i = 0; i < PEN_OUTLINE_POINTS; ++i) {
+        double angle = 2.0 * std::numbers::pi * i / PEN_OUTLINE_POINTS;
+        ring[i] = cv::Point(static_cast<int>(std::lround(6.0 * std::cos(angle))),
+                            static_cast<int>(std::lround(6.0 * std::sin(angle))));
+    }
+    return ring;
+}
+
+} // namespace
+
+// One epicycle chain (one shape). All chains share the origin and the time
+// axis, so every chain's traced path is the same prefix of its trajectory.
+struct AnimationEngine::Chain {
+    std::vector<FourierCoefficient> coefficients;
+    EpicycleEvaluator evaluator;
+    CoefficientSoA soa;
+    std::vector<cv::Point2d> positions;  // Reused every frame
+    
+    // Pen trajectory in sub-pixel screen coordinates, sampled
+    // samplesPerFrame times per frame by one inverse FFT; the path at frame
+    // i is the prefix [0, i * samplesPerFrame]
+    std::vector<cv::Point2d> trajectory;
+    
+    // Level of detail: terms [lodCutoff, size) are drawn as one vector
+    size_t lodCutoff = 0;
+};
+
 class AnimationEngine::Impl {
 public:
-    std::vector<FourierCoefficient> coefficients;
+    std::vector<Chain> chains;
     AnimationConfig config;
-    std::vector<cv::Point> tracedPath;
+    KernelType activeKernel = KernelType::Auto;  // config.kernel after fallback
+    std::unique_ptr<SineTable> sineTable;        // Set when activeKernel is Table
+    
+    int samplesPerFrame = 1;
+    size_t trajectoryLength = 0;  // Samples per chain trajectory
+    size_t tracedCount = 0;
+    
     int currentFrame = 0;
     bool initialized = false;
+    bool useCairo = false;  // Resolved from config.backend
+    FramePool framePool;    // Output frames handed to the caller
+    std::array<cv::Point, PEN_OUTLINE_POINTS> penOutline = penOutlineRing();
+    
+    int culledDraws = 0;  // Summed over chains
+    
+    // Returns the draw calls saved per frame for this chain
+    int computeLod(Chain& chain) {
+        const auto& coefficients = chain.coefficients;
+        const size_t count = coefficients.size();
+        size_t& lodCutoff = chain.lodCutoff;
+        lodCutoff = count;
+        
+        // Grow the tail from the last term while its total screen radius
+        // (an upper bound on how far the folded vector can deviate from
+        // the individual ones) stays within the error
+        double tail = 0.0;
+        while (config.lodPixelError > 0.0 && lodCutoff > 0) {
+            double next = tail + coefficients[lodCutoff - 1].amplitude * config.scale;
+            if (next > config.lodPixelError) break;
+            tail = next;
+            --lodCutoff;
+        }
+        
+        // A single-term tail saves nothing
+        if (count - lodCutoff < 2) lodCutoff = count;
+        
+        int culled = 0;
+        if (lodCutoff < count) {
+            if (config.showVectors) culled += static_cast<int>(count - lodCutoff) - 1;
+            if (config.showCircles) {
+                for (size_t i = lodCutoff; i < count; ++i) {
+                    if (coefficients[i].amplitude * config.scale > 1) culled++;
+                }
+            }
+        }
+        return culled;
+    }
+    
+    // Dirty rectangles. A pooled frame still shows the render it last held,
+    // so only the regions changed since then are restored from the path
+    // layer before the chain is redrawn. Every render records its changed
+    // rect (previous chain | new path segments | current chain) in a ring.
+    uint64_t renderSerial = 0;            // Renders so far (0 = none)
+    cv::Rect previousChain;
+    bool layerChanged = true;             // Path layer rebuilt since last render
+    std::vector<cv::Rect> changeHistory;  // Changed rect of render n at n % size
+    std::vector<uint64_t> slotSerial;     // Render each pool slot last held
+    uint64_t surfaceSerial = 0;           // Render the Cairo surface last held
+    
+    void resetDirtyTracking() {
+        int slots = std::max(config.framePoolSize, 1);
+        renderSerial = 0;
+        previousChain = cv::Rect();
+        layerChanged = true;
+        changeHistory.assign(2 * slots + 2, cv::Rect());
+        slotSerial.assign(slots, 0);
+        surfaceSerial = 0;
+    }
     
+    cv::Rect fullFrame() const {
+        return cv::Rect(0, 0, config.resolution.width, config.resolution.height);
+    }
+    
+    // Start a render whose path layer grew by pathAdded and whose chain
+    // covers chain; returns the rect this render changes
+    cv::Rect recordChange(const cv::Rect& pathAdded, const cv::Rect& chain) {
+        cv::Rect changed = layerChanged
+            ? fullFrame()
+            : unite(unite(previousChain, pathAdded), chain) & fullFrame();
+        
+        renderSerial++;
+        changeHistory[renderSerial % changeHistory.size()] = changed;
+        previousChain = chain;
+        layerChanged = false;
+        return changed;
+    }
+    
+    // Region a buffer that last held render `serial` must refresh to show
+    // the current render; marks it as holding the current render
+    cv::Rect claim(uint64_t& serial) {
+        cv::Rect region;
+        if (!config.dirtyRectangles || serial == 0 ||
+            renderSerial - serial >= changeHistory.size()) {
+            region = fullFrame();
+        } else {
+            for (uint64_t n = serial + 1; n <= renderSerial; ++n) {
+                region = unite(region, changeHistory[n % changeHistory.size()]);
+            }
+        }
+        serial = renderSerial;
+        return region;
+    }
+    
+    // Pooled output frame plus the region of it that must be refreshed
+    cv::Mat acquireFrame(cv::Rect& region) {
+        int slot = -1;
+        cv::Mat frame = framePool.acquire(&slot);
+        if (slot < 0 || slot >= static_cast<int>(slotSerial.size())) {
+            region = fullFrame();
+        } else {
+            region = claim(slotSerial[slot]);
+        }
+        return frame;
+    }
+    
+    // Persistent path layer: background plus every path segment drawn so far.
+    // Each frame appends only its newest segments and the layer is copied
+    // under the epicycles, so path cost per frame stays constant.
+    cv::Mat pathLayer;
+    size_t pathLayerSegments = 0;
+    
+    void clearPathLayer() {
+        pathLayer.create(config.resolution, CV_8UC3);
+        pathLayer.setTo(config.backgroundColor);
+        pathLayerSegments = 0;
+    }
+
 #ifdef USE_CAIRO
     cairo_surface_t* surface = nullptr;
     cairo_t* cr = nullptr;
+    cairo_surface_t* pathSurface = nullptr;
+    cairo_t* pathCr = nullptr;
     
     void initCairo(int width, int height) {
-        if (surface) cairo_surface_destroy(surface);
-        if (cr) cairo_destroy(cr);
+        destroyCairo();
         
         surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
         cr = cairo_create(surface);
         
+        pathSurface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+        pathCr = cairo_create(pathSurface);
+        
         // Enable antialiasing
         cairo_set_antialias(cr, CAIRO_ANTIALIAS_BEST);
+        cairo_set_antialias(pathCr, CAIRO_ANTIALIAS_BEST);
+    }
+    
+    void clearPathSurface() {
+        cairo_set_source_rgb(pathCr,
+            config.backgroundColor[2] / 255.0,
+            config.backgroundColor[1] / 255.0,
+            config.backgroundColor[0] / 255.0);
+        cairo_paint(pathCr);
+        pathLayerSegments = 0;
     }
     
     void destroyCairo() {
         if (cr) { cairo_destroy(cr); cr = nullptr; }
         if (surface) { cairo_surface_destroy(surface); surface = nullptr; }
+        if (pathCr) { cairo_destroy(pathCr); pathCr = nullptr; }
+        if (pathSurface) { cairo_surface_destroy(pathSurface); pathSurface = nullptr; }
     }
     
     cv::Mat cairoToMat() {
+        FOURIER_PROFILE_SCOPE("cairoToMat");
         cairo_surface_flush(surface);
         unsigned char* data = cairo_image_surface_get_data(surface);
         int width = cairo_image_surface_get_width(surface);
         int height = cairo_image_surface_get_height(surface);
         int stride = cairo_image_surface_get_stride(surface);
         
-        // Cairo uses ARGB, OpenCV uses BGRA
+        // Cairo uses ARGB, OpenCV uses BGRA; convert straight from the
+        // surface into a pooled frame (no intermediate Mat, no clone),
+        // only where that frame differs from the current render
         cv::Mat mat(height, width, CV_8UC4, data, stride);
-        cv::Mat result;
-        cv::cvtColor(mat, result, cv::COLOR_BGRA2BGR);
-        return result.clone();
+        cv::Rect region;
+        cv::Mat result = acquireFrame(region);
+        if (!region.empty()) {
+            cv::Mat target = result(region);
+            cv::cvtColor(mat(region), target, cv::COLOR_BGRA2BGR);
+        }
+        return result;
     }
 #endif
+
+    void resetPathLayer() {
+        layerChanged = true;
+#ifdef USE_CAIRO
+        if (useCairo) {
+            clearPathSurface();
+            return;
+        }
+#endif
+        clearPathLayer();
+    }
+    
+    std::span<const cv::Point2d> tracedPath(const Chain& chain) const {
+        return std::span<const cv::Point2d>(chain.trajectory.data(),
+                                            std::min(tracedCount, chain.trajectory.size()));
+    }
+    
+    // Make the traced path the first `count` trajectory samples without
+    // depending on which frames were rendered before; the path layer is
+    // rebuilt when going back
+    void setPathPrefix(size_t count) {
+        count = std::min(count, trajectoryLength);
+        if (count < tracedCount && pathLayerSegments + 1 > count) {
+            resetPathLayer();
+        }
+        tracedCount = count;
+    }
+    
+    // Everything derived from the coefficients; returns false when the
+    // requested table kernel had to fall back to exact trig
+    bool loadCoefficients(const std::vector<std::vector<FourierCoefficient>>& newChains) {
+        chains.resize(newChains.size());
+        for (size_t i = 0; i < chains.size(); ++i) {
+            auto& chain = chains[i];
+            chain.coefficients = newChains[i];
+            chain.evaluator.reset(chain.coefficients, config.totalFrames);
+            chain.soa = CoefficientSoA::fromCoefficients(chain.coefficients);
+        }
+        
+        // Table trig only when its error bound at this scale is sub-pixel
+        // enough; one table, sized for the most demanding chain
+        bool kernelAvailable = true;
+        activeKernel = resolveKernel(config.kernel);
+        int log2Size = 0;
+        if (!config.usePhasorEvaluator && activeKernel == KernelType::Table) {
+            log2Size = SineTable::MIN_LOG2_SIZE;
+            for (const auto& chain : chains) {
+                int needed = SineTable::chooseLog2Size(chain.soa, config.scale, config.trigMaxPixelError);
+                log2Size = (needed > 0 && log2Size > 0) ? std::max(log2Size, needed) : 0;
+            }
+            if (log2Size == 0) {
+                activeKernel = resolveKernel(KernelType::Auto);
+                kernelAvailable = false;
+            }
+        }
+        // A refit that needs the same size keeps the table
+        if (log2Size == 0) {
+            sineTable.reset();
+        } else if (!sineTable || sineTable->size() != (1 << log2Size)) {
+            sineTable = std::make_unique<SineTable>(log2Size);
+        }
+        
+        // Precompute the whole pen trajectory so that any frame's path is a
+        // prefix of it (frames may be rendered in any order)
+        computeTrajectory();
+        
+        culledDraws = 0;
+        for (auto& chain : chains) {
+            culledDraws += computeLod(chain);
+        }
+        return kernelAvailable;
+    }
+    
+    std::vector<std::complex<double>> spectrumScratch;
+    std::vector<std::complex<double>> samplesScratch;
+    
+    void computeTrajectory() {
+        trajectoryLength = 0;
+        tracedCount = 0;
+        if (config.totalFrames <= 0) {
+            for (auto& chain : chains) {
+                chain.trajectory.clear();
+            }
+            return;
+        }
+        
+        // The table must resolve the highest frequency kept
+        int maxFrequency = 0;
+        for (const auto& chain : chains) {
+            for (const auto& coef : chain.coefficients) {
+                maxFrequency = std::max(maxFrequency, std::abs(coef.frequency));
+            }
+        }
+        samplesPerFrame = std::max(config.pathSamplesPerFrame, 1);
+        samplesPerFrame = std::max(samplesPerFrame, 2 * maxFrequency / config.totalFrames + 1);
+        trajectoryLength = static_cast<size_t>(config.totalFrames) * samplesPerFrame;
+        
+        // Buffers and the cached FFT plan are reused by every refit
+        for (auto& chain : chains) {
+            sampleTrajectory(chain.coefficients, static_cast<int>(trajectoryLength),
+                             spectrumScratch, samplesScratch);
+            chain.trajectory.resize(samplesScratch.size());
+            for (size_t i = 0; i < samplesScratch.size(); ++i) {
+                const auto& z = samplesScratch[i];
+                chain.trajectory[i] = cv::Point2d(config.center.x + z.real() * config.scale,
+                                                  config.center.y + z.imag() * config.scale);
+            }
+        }
+    }
+    
+    size_t termCount() const {
+        size_t count = 0;
+        for (const auto& chain : chains) count += chain.coefficients.size();
+        return count;
+    }
+    
+    size_t foldedTerms() const {
+        size_t folded = 0;
+        for (const auto& chain : chains) folded += chain.coefficients.size() - chain.lodCutoff;
+        return folded;
+    }
 };
 
 AnimationEngine::AnimationEngine() : pImpl(std::make_unique<Impl>()) {}
@@ -64,25 +405,93 @@ AnimationEngine::~AnimationEngine() {
 
 void AnimationEngine::initialize(const std::vector<FourierCoefficient>& coefficients,
                                  const AnimationConfig& config) {
-    pImpl->coefficients = coefficients;
+    initialize(std::vector<std::vector<FourierCoefficient>>{coefficients}, config);
+}
+
+void AnimationEngine::initialize(const std::vector<std::vector<FourierCoefficient>>& chains,
+                                 const AnimationConfig& config) {
     pImpl->config = config;
-    pImpl->tracedPath.clear();
-    pImpl->tracedPath.reserve(config.totalFrames);
     pImpl->currentFrame = 0;
     pImpl->initialized = true;
     
+    if (!pImpl->loadCoefficients(chains)) {
+        std::cout << "[Animation] Sine table cannot reach " << config.trigMaxPixelError
+                  << " px at this scale, using exact trig" << std::endl;
+    }
+    
+    pImpl->framePool.setCapacity(config.framePoolSize);
+    pImpl->framePool.reset(config.resolution, CV_8UC3);
+    pImpl->resetDirtyTracking();
+
 #ifdef USE_CAIRO
-    pImpl->initCairo(config.resolution.width, config.resolution.height);
-    std::cout << "[Animation] Using Cairo for high-quality rendering" << std::endl;
+    pImpl->useCairo = config.backend != RenderBackend::OpenCV;
 #else
-    std::cout << "[Animation] Using OpenCV for rendering (install Cairo for better quality)" << std::endl;
+    pImpl->useCairo = false;
 #endif
+
+    if (pImpl->useCairo) {
+#ifdef USE_CAIRO
+        pImpl->initCairo(config.resolution.width, config.resolution.height);
+        pImpl->clearPathSurface();
+        std::cout << "[Animation] Using Cairo for high-quality rendering" << std::endl;
+#endif
+    } else {
+        pImpl->clearPathLayer();
+        std::cout << "[Animation] Using OpenCV for rendering";
+#ifndef USE_CAIRO
+        std::cout << " (install Cairo for better quality)";
+#endif
+        std::cout << std::endl;
+    }
     
-    std::cout << "[Animation] Initialized with " << coefficients.size() 
-              << " epicycles, " << config.totalFrames << " frames" << std::endl;
+    std::cout << "[Animation] Initialized with " << pImpl->termCount() 
+              << " epicycles";
+    if (chains.size() > 1) {
+        std::cout << " in " << chains.size() << " chains";
+    }
+    std::cout << ", " << config.totalFrames << " frames, "
+              << pImpl->samplesPerFrame << " path samples per frame" << std::endl;
+    if (pImpl->foldedTerms() > 0) {
+        std::cout << "[Animation] LOD: " << pImpl->foldedTerms()
+                  << " tail terms (< " << config.lodPixelError << " px) drawn as one vector, "
+                  << pImpl->culledDraws << " draws culled per frame" << std::endl;
+    }
+    std::cout << "[Animation] Evaluator: "
+              << (config.usePhasorEvaluator ? "phasor" : kernelName(pImpl->activeKernel));
+    if (pImpl->sineTable) {
+        double bound = 0.0;
+        for (const auto& chain : pImpl->chains) {
+            bound = std::max(bound, pImpl->sineTable->positionErrorBound(chain.soa, config.scale));
+        }
+        std::cout << " (" << pImpl->sineTable->size() << " entries, error <= " << bound << " px)";
+    }
+    std::cout << std::endl;
+}
+
+void AnimationEngine::setCoefficients(const std::vector<FourierCoefficient>& coefficients) {
+    if (!pImpl->initialized) {
+        initialize(coefficients, pImpl->config);
+        return;
+    }
+    
+    // Frame pool, surfaces, trajectory buffers and the sine table stay; the
+    // path layer belongs to the old shape. Without a path the layer is
+    // plain background: nothing to clear, and no prefix is redrawn.
+    pImpl->loadCoefficients(std::vector<std::vector<FourierCoefficient>>{coefficients});
+    if (pImpl->config.showPath) {
+        pImpl->resetPathLayer();
+    }
+}
+
+void AnimationEngine::setCoefficients(const std::vector<FourierCoefficient>& coefficients,
+                                      const cv::Point2d& center, double scale) {
+    pImpl->config.center = center;
+    pImpl->config.scale = scale;
+    setCoefficients(coefficients);
 }
 
 cv::Mat AnimationEngine::renderFrame(int frameIndex) {
+    FOURIER_PROFILE_SCOPE("renderFrame");
     if (!pImpl->initialized) {
         std::cerr << "[Animation] Not initialized!" << std::endl;
         return cv::Mat();
@@ -94,47 +503,66 @@ cv::Mat AnimationEngine::renderFrame(int frameIndex) {
     // Calculate time parameter (0 to 2*PI for one full cycle)
     double t = TWO_PI * static_cast<double>(frameIndex) / config.totalFrames;
     
-    // Get epicycle positions
-    auto positions = getEpicyclePositions(pImpl->coefficients, t);
-    
-    // Add final point to traced path
-    if (!positions.empty()) {
-        cv::Point screenPoint = worldToScreen(positions.back());
-        pImpl->tracedPath.push_back(screenPoint);
+    // Get epicycle positions (phasor recurrence, or direct SoA kernel)
+    for (auto& chain : pImpl->chains) {
+        if (config.usePhasorEvaluator) {
+            chain.evaluator.evaluate(frameIndex, chain.positions);
+        } else if (pImpl->sineTable) {
+            evaluateEpicycles(chain.soa, t, chain.positions, *pImpl->sineTable);
+        } else {
+            evaluateEpicycles(chain.soa, t, chain.positions, pImpl->activeKernel);
+        }
     }
+    
+    // Traced path is the trajectory up to and including this frame
+    pImpl->setPathPrefix(static_cast<size_t>(std::max(frameIndex, 0)) * pImpl->samplesPerFrame + 1);
 
 #ifdef USE_CAIRO
-    return renderFrameCairo(positions, t);
-#else
-    return renderFrameOpenCV(positions, t);
+    if (pImpl->useCairo) {
+        return renderFrameCairo(t);
+    }
 #endif
+    return renderFrameOpenCV(t);
 }
 
 #ifdef USE_CAIRO
-cv::Mat AnimationEngine::renderFrameCairo(const std::vector<cv::Point2d>& positions, double t) {
+cv::Mat AnimationEngine::renderFrameCairo(double t) {
     const auto& config = pImpl->config;
     cairo_t* cr = pImpl->cr;
     
-    // Clear background
-    cairo_set_source_rgb(cr, 
-        config.backgroundColor[2] / 255.0,
-        config.backgroundColor[1] / 255.0, 
-        config.backgroundColor[0] / 255.0);
-    cairo_paint(cr);
-    
-    // Draw path first (back layer)
+    // Path layer first (back layer): extend it, then restore the surface
+    // from it where this render differs from the one the surface holds
+    // (without a path the layer is plain background)
+    cv::Rect pathAdded;
     if (config.showPath) {
-        drawPathCairo(cr);
+        pathAdded = drawPathCairo(pImpl->pathCr);
     }
+    cv::Rect chainArea;
+    for (const auto& chain : pImpl->chains) {
+        chainArea = unite(chainArea, chainBounds(chain));
+    }
+    pImpl->recordChange(pathAdded, chainArea);
+    cv::Rect region = pImpl->claim(pImpl->surfaceSerial);
+    
+    cairo_save(cr);
+    cairo_rectangle(cr, region.x, region.y, region.width, region.height);
+    cairo_clip(cr);
+    cairo_set_source_surface(cr, pImpl->pathSurface, 0, 0);
+    cairo_paint(cr);
+    cairo_restore(cr);
     
     // Draw circles
     if (config.showCircles) {
-        drawCirclesCairo(cr, positions);
+        for (const auto& chain : pImpl->chains) {
+            drawCirclesCairo(cr, chain);
+        }
     }
     
     // Draw vectors
     if (config.showVectors) {
-        drawVectorsCairo(cr, positions);
+        for (const auto& chain : pImpl->chains) {
+            drawVectorsCairo(cr, chain);
+        }
     }
     
     // Draw origin marker
@@ -142,9 +570,10 @@ cv::Mat AnimationEngine::renderFrameCairo(const std::vector<cv::Point2d>& positi
         drawOriginMarkerCairo(cr);
     }
     
-    // Draw current drawing point
-    if (!positions.empty()) {
-        cv::Point endPoint = worldToScreen(positions.back());
+    // Draw current drawing point of every chain
+    for (const auto& chain : pImpl->chains) {
+        if (chain.positions.empty()) continue;
+        cv::Point endPoint = worldToScreen(chain.positions.back());
         
         // Yellow filled circle with white outline
         cairo_arc(cr, endPoint.x, endPoint.y, 6, 0, TWO_PI);
@@ -158,13 +587,16 @@ cv::Mat AnimationEngine::renderFrameCairo(const std::vector<cv::Point2d>& positi
     return pImpl->cairoToMat();
 }
 
-void AnimationEngine::drawCirclesCairo(cairo_t* cr, const std::vector<cv::Point2d>& positions) {
+void AnimationEngine::drawCirclesCairo(cairo_t* cr, const Chain& chain) {
+    FOURIER_PROFILE_SCOPE("drawCirclesCairo");
     const auto& config = pImpl->config;
-    const auto& coefficients = pImpl->coefficients;
+    const auto& coefficients = chain.coefficients;
+    const auto& positions = chain.positions;
     
     cairo_set_line_width(cr, config.circleThickness);
     
-    for (size_t i = 0; i < coefficients.size() && i < positions.size(); ++i) {
+    const size_t drawn = std::min(chain.lodCutoff, coefficients.size());
+    for (size_t i = 0; i < drawn && i < positions.size(); ++i) {
         cv::Point center = worldToScreen(positions[i]);
         double radius = coefficients[i].amplitude * config.scale;
         
@@ -182,16 +614,21 @@ void AnimationEngine::drawCirclesCairo(cairo_t* cr, const std::vector<cv::Point2
     }
 }
 
-void AnimationEngine::drawVectorsCairo(cairo_t* cr, const std::vector<cv::Point2d>& positions) {
+void AnimationEngine::drawVectorsCairo(cairo_t* cr, const Chain& chain) {
+    FOURIER_PROFILE_SCOPE("drawVectorsCairo");
     const auto& config = pImpl->config;
-    const auto& coefficients = pImpl->coefficients;
+    const auto& coefficients = chain.coefficients;
+    const auto& positions = chain.positions;
     
     cairo_set_line_width(cr, config.vectorThickness);
     cairo_set_line_cap(cr, CAIRO_LINE_CAP_ROUND);
     
-    for (size_t i = 0; i + 1 < positions.size() && i < coefficients.size(); ++i) {
+    // Terms past the LOD cutoff are folded into one vector ending at the pen
+    const size_t drawn = std::min(chain.lodCutoff, coefficients.size());
+    for (size_t i = 0; i + 1 < positions.size() && i <= drawn && i < coefficients.size(); ++i) {
+        size_t next = (i == drawn) ? positions.size() - 1 : i + 1;
         cv::Point start = worldToScreen(positions[i]);
-        cv::Point end = worldToScreen(positions[i + 1]);
+        cv::Point end = worldToScreen(positions[next]);
         
         cairo_set_source_rgb(cr,
             coefficients[i].color[2] / 255.0,
@@ -204,33 +641,43 @@ void AnimationEngine::drawVectorsCairo(cairo_t* cr, const std::vector<cv::Point2
     }
 }
 
-void AnimationEngine::drawPathCairo(cairo_t* cr) {
+cv::Rect AnimationEngine::drawPathCairo(cairo_t* cr) {
+    FOURIER_PROFILE_SCOPE("drawPathCairo");
     const auto& config = pImpl->config;
-    const auto& path = pImpl->tracedPath;
+    const size_t traced = std::min(pImpl->tracedCount, pImpl->trajectoryLength);
     
-    if (path.size() < 2) return;
+    if (traced < 2 || pImpl->pathLayerSegments + 1 >= traced) return cv::Rect();
     
     cairo_set_line_width(cr, config.pathThickness);
     cairo_set_line_cap(cr, CAIRO_LINE_CAP_ROUND);
     cairo_set_line_join(cr, CAIRO_LINE_JOIN_ROUND);
     
-    // Draw path with gradient effect
-    for (size_t i = 1; i < path.size(); ++i) {
-        double alpha = static_cast<double>(i) / path.size();
-        
-        cairo_set_source_rgba(cr,
-            alpha,                          // R
-            0.8 * alpha,                    // G
-            (100 + 155 * alpha) / 255.0,    // B
-            0.8 + 0.2 * alpha);             // Alpha
-        
-        cairo_move_to(cr, path[i-1].x, path[i-1].y);
-        cairo_line_to(cr, path[i].x, path[i].y);
-        cairo_stroke(cr);
+    // Draw only the segments not yet on the path layer, with gradient effect
+    cv::Rect added;
+    for (const auto& chain : pImpl->chains) {
+        const auto path = pImpl->tracedPath(chain);
+        for (size_t i = pImpl->pathLayerSegments + 1; i < path.size(); ++i) {
+            double alpha = pathSegmentAlpha(i);
+            
+            cairo_set_source_rgba(cr,
+                alpha,                          // R
+                0.8 * alpha,                    // G
+                (100 + 155 * alpha) / 255.0,    // B
+                0.8 + 0.2 * alpha);             // Alpha
+            
+            cairo_move_to(cr, path[i-1].x, path[i-1].y);
+            cairo_line_to(cr, path[i].x, path[i].y);
+            cairo_stroke(cr);
+        }
+        added = unite(added, segmentBounds(path, pImpl->pathLayerSegments, config.pathThickness));
     }
+    
+    pImpl->pathLayerSegments = traced - 1;
+    return added;
 }
 
 void AnimationEngine::drawOriginMarkerCairo(cairo_t* cr) {
+    FOURIER_PROFILE_SCOPE("drawOriginMarkerCairo");
     const auto& config = pImpl->config;
     cv::Point origin = worldToScreen(cv::Point2d(0, 0));
     
@@ -255,45 +702,71 @@ void AnimationEngine::drawOriginMarkerCairo(cairo_t* cr) {
 }
 #endif
 
-cv::Mat AnimationEngine::renderFrameOpenCV(const std::vector<cv::Point2d>& positions, double t) {
+cv::Mat AnimationEngine::renderFrameOpenCV(double t) {
     const auto& config = pImpl->config;
     
-    // Create frame with background color
-    cv::Mat frame(config.resolution, CV_8UC3, config.backgroundColor);
-    
-    // Draw components in order (back to front)
+    // Extend the path layer (back layer; plain background without a path),
+    // then restore a pooled frame from it only where the frame differs from
+    // this render. The chain is drawn inside its own bounds, which are part
+    // of that region, so the rest of the frame is already correct.
+    cv::Rect pathAdded;
     if (config.showPath) {
-        drawPath(frame);
+        pathAdded = drawPath(pImpl->pathLayer);
+    }
+    cv::Rect chainArea;
+    for (const auto& chain : pImpl->chains) {
+        chainArea = unite(chainArea, chainBounds(chain));
     }
+    pImpl->recordChange(pathAdded, chainArea);
     
+    cv::Rect region;
+    cv::Mat frame = pImpl->acquireFrame(region);
+    if (!region.empty()) {
+        cv::Mat target = frame(region);
+        pImpl->pathLayer(region).copyTo(target);
+    }
+    
+    // Draw remaining components in order (back to front)    
     if (config.showCircles) {
-        drawCircles(frame, positions, t);
+        for (const auto& chain : pImpl->chains) {
+            drawCircles(frame, chain, t);
+        }
     }
     
     if (config.showVectors) {
-        drawVectors(frame, positions);
+        for (const auto& chain : pImpl->chains) {
+            drawVectors(frame, chain);
+        }
     }
     
     if (config.showOriginMarker) {
         drawOriginMarker(frame);
     }
     
-    // Draw current drawing point
-    if (!positions.empty()) {
-        cv::Point endPoint = worldToScreen(positions.back());
+    // Draw current drawing point of every chain
+    for (const auto& chain : pImpl->chains) {
+        if (chain.positions.empty()) continue;
+        cv::Point endPoint = worldToScreen(chain.positions.back());
         cv::circle(frame, endPoint, 6, cv::Scalar(0, 255, 255), -1);  // Yellow filled
-        cv::circle(frame, endPoint, 6, cv::Scalar(255, 255, 255), 2); // White outline
+        const auto& ring = pImpl->penOutline;                          // White outline
+        for (int k = 0; k < PEN_OUTLINE_POINTS; ++k) {
+            cv::line(frame, endPoint + ring[k], endPoint + ring[(k + 1) % PEN_OUTLINE_POINTS],
+                     cv::Scalar(255, 255, 255), 2);
+        }
     }
     
     return frame;
 }
 
-void AnimationEngine::drawCircles(cv::Mat& frame, const std::vector<cv::Point2d>& positions, double t) {
+void AnimationEngine::drawCircles(cv::Mat& frame, const Chain& chain, double t) {
+    FOURIER_PROFILE_SCOPE("drawCircles");
     (void)t;  // Unused in OpenCV version
     const auto& config = pImpl->config;
-    const auto& coefficients = pImpl->coefficients;
+    const auto& coefficients = chain.coefficients;
+    const auto& positions = chain.positions;
     
-    for (size_t i = 0; i < coefficients.size() && i < positions.size(); ++i) {
+    const size_t drawn = std::min(chain.lodCutoff, coefficients.size());
+    for (size_t i = 0; i < drawn && i < positions.size(); ++i) {
         cv::Point center = worldToScreen(positions[i]);
         int radius = static_cast<int>(coefficients[i].amplitude * config.scale);
         
@@ -303,35 +776,54 @@ void AnimationEngine::drawCircles(cv::Mat& frame, const std::vector<cv::Point2d>
     }
 }
 
-void AnimationEngine::drawVectors(cv::Mat& frame, const std::vector<cv::Point2d>& positions) {
+void AnimationEngine::drawVectors(cv::Mat& frame, const Chain& chain) {
+    FOURIER_PROFILE_SCOPE("drawVectors");
     const auto& config = pImpl->config;
-    const auto& coefficients = pImpl->coefficients;
+    const auto& coefficients = chain.coefficients;
+    const auto& positions = chain.positions;
     
-    for (size_t i = 0; i + 1 < positions.size() && i < coefficients.size(); ++i) {
+    // Terms past the LOD cutoff are folded into one vector ending at the pen
+    const size_t drawn = std::min(chain.lodCutoff, coefficients.size());
+    for (size_t i = 0; i + 1 < positions.size() && i <= drawn && i < coefficients.size(); ++i) {
+        size_t next = (i == drawn) ? positions.size() - 1 : i + 1;
         cv::Point start = worldToScreen(positions[i]);
-        cv::Point end = worldToScreen(positions[i + 1]);
+        cv::Point end = worldToScreen(positions[next]);
         cv::line(frame, start, end, coefficients[i].color, config.vectorThickness);
     }
 }
 
-void AnimationEngine::drawPath(cv::Mat& frame) {
+cv::Rect AnimationEngine::drawPath(cv::Mat& layer) {
+    FOURIER_PROFILE_SCOPE("drawPath");
     const auto& config = pImpl->config;
-    const auto& path = pImpl->tracedPath;
-    
-    if (path.size() < 2) return;
-    
-    for (size_t i = 1; i < path.size(); ++i) {
-        double alpha = static_cast<double>(i) / path.size();
-        cv::Scalar color(
-            static_cast<int>(100 + 155 * alpha),
-            static_cast<int>(200 * alpha),
-            static_cast<int>(255 * alpha)
-        );
-        cv::line(frame, path[i-1], path[i], color, config.pathThickness);
+    const size_t traced = std::min(pImpl->tracedCount, pImpl->trajectoryLength);
+    
+    if (traced < 2 || pImpl->pathLayerSegments + 1 >= traced) return cv::Rect();
+    
+    // Draw only the segments not yet on the path layer
+    cv::Rect added;
+    for (const auto& chain : pImpl->chains) {
+        const auto path = pImpl->tracedPath(chain);
+        for (size_t i = pImpl->pathLayerSegments + 1; i < path.size(); ++i) {
+            double alpha = pathSegmentAlpha(i);
+            cv::Scalar color(
+                static_cast<int>(100 + 155 * alpha),
+                static_cast<int>(200 * alpha),
+                static_cast<int>(255 * alpha)
+            );
+            // LINE_8 as before: with LINE_AA, thick lines get their round
+            // caps from EllipseEx, which allocates per segment
+            cv::line(layer, toFixedPoint(path[i-1]), toFixedPoint(path[i]), color,
+                     config.pathThickness, cv::LINE_8, PATH_SHIFT);
+        }
+        added = unite(added, segmentBounds(path, pImpl->pathLayerSegments, config.pathThickness));
     }
+    
+    pImpl->pathLayerSegments = traced - 1;
+    return added;
 }
 
 void AnimationEngine::drawOriginMarker(cv::Mat& frame) {
+    FOURIER_PROFILE_SCOPE("drawOriginMarker");
     const auto& config = pImpl->config;
     cv::Point origin = worldToScreen(cv::Point2d(0, 0));
     
@@ -353,13 +845,65 @@ cv::Point AnimationEngine::worldToScreen(const cv::Point2d& worldPoint) const {
     return cv::Point(screenX, screenY);
 }
 
-const std::vector<cv::Point>& AnimationEngine::getTracedPath() const {
-    return pImpl->tracedPath;
+cv::Rect AnimationEngine::chainBounds(const Chain& chain) const {
+    const auto& config = pImpl->config;
+    const auto& coefficients = chain.coefficients;
+    const auto& positions = chain.positions;
+    
+    // Origin marker, including the Cairo "a0" label
+    cv::Point origin = worldToScreen(cv::Point2d(0, 0));
+    int minX = origin.x - 12, maxX = origin.x + 44;
+    int minY = origin.y - 24, maxY = origin.y + 12;
+    
+    auto include = [&](const cv::Point& p, int radius) {
+        minX = std::min(minX, p.x - radius);
+        maxX = std::max(maxX, p.x + radius);
+        minY = std::min(minY, p.y - radius);
+        maxY = std::max(maxY, p.y + radius);
+    };
+    
+    // Vectors join consecutive positions; circle i is centred on position i
+    for (size_t i = 0; i < positions.size(); ++i) {
+        cv::Point center = worldToScreen(positions[i]);
+        int radius = 0;
+        if (config.showCircles && i < chain.lodCutoff && i < coefficients.size()) {
+            radius = static_cast<int>(std::ceil(coefficients[i].amplitude * config.scale));
+        }
+        include(center, radius);
+    }
+    
+    // Pen marker (radius 6, outline 2)
+    if (!positions.empty()) {
+        include(worldToScreen(positions.back()), 9);
+    }
+    
+    int pad = std::max(config.circleThickness, config.vectorThickness) + 2;
+    return cv::Rect(minX - pad, minY - pad, maxX - minX + 2 * pad + 1, maxY - minY + 2 * pad + 1);
+}
+
+double AnimationEngine::pathSegmentAlpha(size_t segmentIndex) const {
+    // Gradient is fixed per segment (it reaches 1.0 on the last frame), so
+    // segments already on the path layer never need to be recolored
+    const double totalSegments = std::max(pImpl->config.totalFrames, 1) * pImpl->samplesPerFrame;
+    return std::min(1.0, static_cast<double>(segmentIndex) / totalSegments);
+}
+
+std::span<const cv::Point2d> AnimationEngine::getTracedPath(size_t chain) const {
+    if (chain >= pImpl->chains.size()) return {};
+    return pImpl->tracedPath(pImpl->chains[chain]);
+}
+
+size_t AnimationEngine::getChainCount() const {
+    return pImpl->chains.size();
 }
 
 void AnimationEngine::reset() {
-    pImpl->tracedPath.clear();
+    pImpl->tracedCount = 0;
     pImpl->currentFrame = 0;
+    
+    if (pImpl->initialized) {
+        pImpl->resetPathLayer();
+    }
 }
 
 bool AnimationEngine::isComplete() const {
@@ -371,4 +915,12 @@ double AnimationEngine::getProgress() const {
     return static_cast<double>(pImpl->currentFrame) / pImpl->config.totalFrames;
 }
 
+int AnimationEngine::getCulledDrawsPerFrame() const {
+    return pImpl->culledDraws;
+}
+
+FramePoolStats AnimationEngine::getFramePoolStats() const {
+    return pImpl->framePool.getStats();
+}
+
 } // namespace fourier
@@ -0,0 +1,455 @@
+#include "batch_processor.hpp"
+#include "frame_sink.hpp"
+#include "coefficient_cache.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace fourier {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+bool isImageFile(const fs::path& path) {
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    for (const char* known : {".png", ".jpg", ".jpeg", ".bmp", ".tif", ".tiff", ".webp"}) {
+        if (ext == known) return true;
+    }
+    return false;
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::ostringstream out;
+    for (char c : text) {
+        switch (c) {
+            case '"':  out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                        << static_cast<int>(c) << std::dec;
+                } else {
+                    out << c;
+                }
+        }
+    }
+    return out.str();
+}
+
+} // namespace
+
+namespace {
+
+// Encode side of one job. Its writer is opened, fed and closed on the
+// encoder the job is pinned to.
+struct EncodeJob {
+    VideoConfig video;
+    VideoWriter writer;
+    bool opened = false;              // Encoder thread only
+    std::atomic<bool> failed{false};  // Set by the encoder; the render worker stops
+    std::string errorMessage;         // Written before failed is set
+    Clock::time_point start;
+};
+
+// A frame (or the end) of a job on its way to an encoder
+struct EncodeItem {
+    size_t job = 0;
+    cv::Mat frame;
+    int repeats = 1;
+    bool finish = false;       // Close the job's writer after its queued frames
+    std::string renderError;   // With finish: why rendering stopped
+};
+
+// One encode thread and its bounded queue, fed by every render worker
+// whose jobs are pinned to it (so each job's frames stay in order)
+struct Encoder {
+    std::mutex mutex;
+    std::condition_variable itemAdded;
+    std::condition_variable spaceFreed;
+    std::deque<EncodeItem> items;
+    size_t capacity = 1;
+    bool closed = false;
+    std::thread thread;
+    
+    void push(EncodeItem&& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        spaceFreed.wait(lock, [&] { return items.size() < capacity; });
+        items.push_back(std::move(item));
+        itemAdded.notify_one();
+    }
+    
+    // false once closed and drained
+    bool pop(EncodeItem& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        itemAdded.wait(lock, [&] { return !items.empty() || closed; });
+        if (items.empty()) return false;
+        item = std::move(items.front());
+        items.pop_front();
+        spaceFreed.notify_all();
+        return true;
+    }
+    
+    void pushFrame(size_t job, const cv::Mat& frame, int repeats) {
+        EncodeItem item;
+        item.job = job;
+        item.frame = frame;
+        item.repeats = repeats;
+        push(std::move(item));
+    }
+    
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        itemAdded.notify_all();
+    }
+};
+
+} // namespace
+
+class BatchProcessor::Impl {
+public:
+    BatchConfig batchConfig;
+    ContourConfig contourConfig;
+    AnimationConfig animConfig;
+    VideoConfig videoConfig;
+    DFTOptions dftOptions;
+    CoefficientCache* cache = nullptr;  // Shared by the render workers (optional)
+    
+    // State of the running batch
+    std::vector<JobResult> results;
+    std::vector<std::unique_ptr<EncodeJob>> jobs;
+    std::vector<std::unique_ptr<Encoder>> encoders;
+    std::mutex logMutex;
+    
+    void log(const std::string& message) {
+        std::lock_guard<std::mutex> lock(logMutex);
+        std::cout << "[Batch] " << message << std::endl;
+    }
+    
+    void report(const JobResult& r) {
+        if (r.success) {
+            std::ostringstream msg;
+            msg << std::fixed << std::setprecision(1) << r.imagePath << " -> " << r.outputPath
+                << " (" << r.framesPerSecond() << " frames/s)";
+            log(msg.str());
+        } else {
+            log("FAILED " + r.imagePath + ": " + r.errorMessage);
+        }
+    }
+    
+    // Output name of every input: its stem, with _2, _3, ... appended when
+    // inputs from different directories share one (a/x.png, b/x.png)
+    static std::vector<std::string> outputStems(const std::vector<std::string>& images) {
+        std::vector<std::string> stems;
+        std::set<std::string> used;
+        for (const auto& image : images) {
+            const std::string base = fs::path(image).stem().string();
+            std::string stem = base;
+            for (int suffix = 2; !used.insert(stem).second; ++suffix) {
+                stem = base + "_" + std::to_string(suffix);
+            }
+            stems.push_back(stem);
+        }
+        return stems;
+    }
+    
+    // Render side of job i (render worker). Frames go to the job's encoder,
+    // which finishes the result; a job failing before its first frame is
+    // reported here.
+    void runJob(size_t i, const std::string& imagePath, const std::string& outputStem,
+                AnimationEngine& engine) {
+        JobResult& result = results[i];
+        EncodeJob& job = *jobs[i];
+        result.imagePath = imagePath;
+        // Image sequences get a directory per image
+        const fs::path stem = fs::path(batchConfig.outputDir) / outputStem;
+        const std::string extension = outputExtension(videoConfig.format);
+        result.outputPath = isImageSequence(videoConfig.format)
+            ? (stem / ("frame_%06d" + extension)).string()
+            : stem.string() + extension;
+        job.start = Clock::now();
+        
+        std::vector<FourierCoefficient> coefficients;
+        try {
+            // A cache hit skips extraction and the DFT; entries are the same
+            // full spectra a single-image run stores
+            const uint64_t cacheKey = cache ? CoefficientCache::key(imagePath, contourConfig,
+                                                                    dftOptions, 1) : 0;
+            CoefficientChains spectra;
+            auto stageStart = Clock::now();
+            if (cacheKey != 0 && cache->load(cacheKey, spectra) && spectra.size() == 1) {
+                result.dftMs = elapsedMs(stageStart);
+                truncateSpectra(spectra, animConfig.numCircles);
+                coefficients = std::move(spectra.front());
+            } else {
+                stageStart = Clock::now();
+                auto contour = extractContour(imagePath, contourConfig);
+                result.contourMs = elapsedMs(stageStart);
+                if (!contour.success) {
+                    throw std::runtime_error(contour.errorMessage);
+                }
+                
+                stageStart = Clock::now();
+                if (cacheKey != 0) {
+                    spectra = {computeDFT(contour.complexPoints, 0, dftOptions)};
+                    cache->store(cacheKey, spectra);
+                    truncateSpectra(spectra, animConfig.numCircles);
+                    coefficients = std::move(spectra.front());
+                } else {
+                    coefficients = computeDFT(contour.complexPoints, animConfig.numCircles, dftOptions);
+                }
+                result.dftMs = elapsedMs(stageStart);
+            }
+        } catch (const std::exception& e) {
+            result.errorMessage = e.what();
+            result.totalMs = elapsedMs(job.start);
+            report(result);
+            return;
+        }
+        
+        engine.initialize(coefficients, animConfig);
+        job.video = videoConfig;
+        job.video.outputPath = result.outputPath;
+        job.video.asyncEncoding = false;  // The encoder thread is the async stage
+        
+        // Keep rendering while the encoder works through earlier frames (or
+        // other jobs); only a full queue makes this worker wait
+        Encoder& encoder = *encoders[i % encoders.size()];
+        EncodeItem finish;
+        finish.job = i;
+        finish.finish = true;
+        cv::Mat frame;
+        for (int f = 0; f < animConfig.totalFrames; ++f) {
+            if (job.failed.load(std::memory_order_acquire)) break;
+            
+            auto stageStart = Clock::now();
+            frame = engine.renderFrame(f);
+            result.renderMs += elapsedMs(stageStart);
+            
+            if (frame.empty()) {
+                finish.renderError = "Failed to render frame " + std::to_string(f);
+                break;
+            }
+            if (f == 0) {
+                encoder.pushFrame(i, frame, job.video.holdFrames(job.video.introHoldSeconds));
+            }
+            encoder.pushFrame(i, frame, 1);
+            result.frames++;
+        }
+        
+        // Same stills as single-image mode, rendered and resized once
+        if (finish.renderError.empty() && !frame.empty()) {
+            encoder.pushFrame(i, frame, job.video.holdFrames(job.video.endHoldSeconds));
+        }
+        encoder.push(std::move(finish));
+    }
+    
+    // Encode side of one item (encoder thread)
+    void encode(EncodeItem& item) {
+        JobResult& result = results[item.job];
+        EncodeJob& job = *jobs[item.job];
+        
+        if (item.finish) {
+            job.writer.release();
+            result.encodeMs = job.writer.getStats().encodeSeconds * 1000.0;
+            result.errorMessage = !item.renderError.empty() ? item.renderError : job.errorMessage;
+            result.success = result.errorMessage.empty();
+            result.totalMs = elapsedMs(job.start);
+            report(result);
+            return;
+        }
+        if (job.failed.load(std::memory_order_relaxed) || item.repeats <= 0) return;
+        
+        if (!job.opened) {
+            job.opened = true;
+            if (!job.writer.open(job.video)) {
+                fail(job, "Failed to open video writer for " + result.outputPath);
+                return;
+            }
+        }
+        bool ok = (item.repeats == 1) ? job.writer.writeFrame(item.frame)
+                                      : job.writer.writeHold(item.frame, item.repeats);
+        if (!ok) {
+            fail(job, "Output failed: " + result.outputPath);
+        }
+    }
+    
+    static void fail(EncodeJob& job, const std::string& message) {
+        job.errorMessage = message;
+        job.failed.store(true, std::memory_order_release);
+    }
+};
+
+BatchProcessor::BatchProcessor(const BatchConfig& batchConfig,
+                               const ContourConfig& contourConfig,
+                               const AnimationConfig& animConfig,
+                               const VideoConfig& videoConfig,
+                               const DFTOptions& dftOptions)
+    : pImpl(std::make_unique<Impl>()) {
+    pImpl->batchConfig = batchConfig;
+    pImpl->contourConfig = contourConfig;
+    pImpl->animConfig = animConfig;
+    pImpl->videoConfig = videoConfig;
+    pImpl->dftOptions = dftOptions;
+}
+
+BatchProcessor::~BatchProcessor() = default;
+
+void BatchProcessor::setCoefficientCache(CoefficientCache* cache) {
+    pImpl->cache = cache;
+}
+
+std::vector<std::string> BatchProcessor::collectInputs(const std::string& dirOrList) {
+    std::vector<std::string> images;
+    std::error_code ec;
+    
+    if (fs::is_directory(dirOrList, ec)) {
+        for (const auto& entry : fs::directory_iterator(dirOrList, ec)) {
+            if (entry.is_regular_file() && isImageFile(entry.path())) {
+                images.push_back(entry.path().string());
+            }
+        }
+        std::sort(images.begin(), images.end());
+        return images;
+    }
+    
+    std::ifstream list(dirOrList);
+    std::string line;
+    while (std::getline(list, line)) {
+        line.erase(0, line.find_first_not_of(" \t\r"));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (!line.empty() && line[0] != '#') {
+            images.push_back(line);
+        }
+    }
+    return images;
+}
+
+std::vector<JobResult> BatchProcessor::run(const std::vector<std::string>& images) {
+    if (images.empty()) return {};
+    
+    std::error_code ec;
+    fs::create_directories(pImpl->batchConfig.outputDir, ec);
+    
+    const int workers = std::clamp(pImpl->batchConfig.renderWorkers, 1,
+                                   static_cast<int>(images.size()));
+    const auto stems = Impl::outputStems(images);
+    pImpl->results.assign(images.size(), JobResult());
+    pImpl->jobs.clear();
+    for (size_t i = 0; i < images.size(); ++i) {
+        pImpl->jobs.push_back(std::make_unique<EncodeJob>());
+    }
+    
+    // A fixed pool of encode threads; each queue holds queueDepth frames
+    // per render worker feeding it
+    const int encoderCount = std::clamp(pImpl->batchConfig.maxEncoders, 1, workers);
+    const int workersPerEncoder = (workers + encoderCount - 1) / encoderCount;
+    pImpl->log("Processing " + std::to_string(images.size()) + " images with " +
+               std::to_string(workers) + " workers, " + std::to_string(encoderCount) + " encoders");
+    pImpl->encoders.clear();
+    for (int e = 0; e < encoderCount; ++e) {
+        auto encoder = std::make_unique<Encoder>();
+        encoder->capacity = static_cast<size_t>(std::max(pImpl->videoConfig.queueDepth, 1) *
+                                                workersPerEncoder);
+        Encoder* self = encoder.get();
+        encoder->thread = std::thread([this, self] {
+            EncodeItem item;
+            while (self->pop(item)) {
+                pImpl->encode(item);
+                item.frame.release();
+            }
+        });
+        pImpl->encoders.push_back(std::move(encoder));
+    }
+    
+    std::atomic<size_t> nextJob{0};
+    auto worker = [&]() {
+        AnimationEngine engine;  // Reused across this worker's jobs
+        for (size_t i = nextJob++; i < images.size(); i = nextJob++) {
+            pImpl->runJob(i, images[i], stems[i], engine);
+        }
+    };
+    
+    std::vector<std::thread> threads;
+    for (int w = 0; w < workers; ++w) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (auto& encoder : pImpl->encoders) {
+        encoder->close();
+        encoder->thread.join();
+    }
+    pImpl->encoders.clear();
+    pImpl->jobs.clear();
+    std::vector<JobResult> results = std::move(pImpl->results);
+    
+    std::string summaryPath = pImpl->batchConfig.summaryPath.empty()
+        ? (fs::path(pImpl->batchConfig.outputDir) / "batch_summary.json").string()
+        : pImpl->batchConfig.summaryPath;
+    if (writeSummary(results, summaryPath)) {
+        pImpl->log("Summary written to " + summaryPath);
+    }
+    
+    return results;
+}
+
+bool BatchProcessor::writeSummary(const std::vector<JobResult>& results, const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "[Batch] Failed to write summary: " << path << std::endl;
+        return false;
+    }
+    
+    int succeeded = 0;
+    out << std::fixed << std::setprecision(3);
+    out << "{\n  \"jobs\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        if (r.success) succeeded++;
+        out << "    {\"image\": \"" << jsonEscape(r.imagePath) << "\""
+            << ", \"output\": \"" << jsonEscape(r.outputPath) << "\""
+            << ", \"success\": " << (r.success ? "true" : "false")
+            << ", \"error\": \"" << jsonEscape(r.errorMessage) << "\""
+            << ", \"frames\": " << r.frames
+            << ", \"frames_per_second\": " << r.framesPerSecond()
+            << ", \"contour_ms\": " << r.contourMs
+            << ", \"dft_ms\": " << r.dftMs
+            << ", \"render_ms\": " << r.renderMs
+            << ", \"encode_ms\": " << r.encodeMs
+            << ", \"total_ms\": " << r.totalMs << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n";
+    out << "  \"succeeded\": " << succeeded << ",\n";
+    out << "  \"failed\": " << (results.size() - succeeded) << "\n";
+    out << "}\n";
+    
+    return static_cast<bool>(out);
+}
+
+} // namespace fourier
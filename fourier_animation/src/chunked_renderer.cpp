@@ -0,0 +1,270 @@
+#include "chunked_renderer.hpp"
+#include "frame_sink.hpp"
+#include "profiler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace fourier {
+
+namespace {
+
+bool fail(std::string* errorMessage, const std::string& message) {
+    if (errorMessage) *errorMessage = message;
+    return false;
+}
+
+// Raw and Y4M: append the bytes; later Y4M chunks lose their stream header
+bool concatenateStreams(const std::vector<std::string>& chunks, const std::string& outputPath,
+                        bool y4m, std::string* errorMessage) {
+    std::FILE* out = (outputPath == "-") ? stdout : std::fopen(outputPath.c_str(), "wb");
+    if (!out) return fail(errorMessage, "Cannot write " + outputPath);
+    
+    std::vector<char> buffer(8 << 20);
+    bool ok = true;
+    for (size_t i = 0; i < chunks.size() && ok; ++i) {
+        std::FILE* in = std::fopen(chunks[i].c_str(), "rb");
+        if (!in) {
+            ok = fail(errorMessage, "Cannot read " + chunks[i]);
+            break;
+        }
+        
+        bool skipHeader = y4m && i > 0;
+        size_t read;
+        while (ok && (read = std::fread(buffer.data(), 1, buffer.size(), in)) > 0) {
+            const char* data = buffer.data();
+            if (skipHeader) {
+                const char* newline = static_cast<const char*>(std::memchr(data, '\n', read));
+                if (!newline) {
+                    ok = fail(errorMessage, "Y4M header too long in " + chunks[i]);
+                    break;
+                }
+                read -= static_cast<size_t>(newline + 1 - data);
+                data = newline + 1;
+                skipHeader = false;
+            }
+            if (std::fwrite(data, 1, read, out) != read) {
+                ok = fail(errorMessage, "Write failed: " + outputPath);
+            }
+        }
+        std::fclose(in);
+    }
+    
+    if (out == stdout) {
+        ok = (std::fflush(out) == 0) && ok;
+    } else {
+        ok = (std::fclose(out) == 0) && ok;
+    }
+    return ok;
+}
+
+} // namespace
+
+bool parseFrameRange(const std::string& text, FrameRange& range) {
+    const size_t colon = text.find(':');
+    if (colon == std::string::npos) return false;
+    
+    try {
+        const std::string start = text.substr(0, colon);
+        const std::string end = text.substr(colon + 1);
+        range.start = start.empty() ? 0 : std::stoi(start);
+        range.end = end.empty() ? -1 : std::stoi(end);
+    } catch (const std::exception&) {
+        return false;
+    }
+    return range.start >= 0 && (range.end < 0 || range.end > range.start);
+}
+
+FrameRange clampFrameRange(const FrameRange& range, int totalFrames) {
+    FrameRange clamped;
+    clamped.end = (range.end < 0) ? totalFrames : std::min(range.end, totalFrames);
+    clamped.start = std::clamp(range.start, 0, clamped.end);
+    return clamped;
+}
+
+std::vector<FrameRange> splitFrameRange(const FrameRange& range, int chunks,
+                                        int keyframeInterval, int keyframeOffset) {
+    std::vector<FrameRange> ranges;
+    const int size = range.size();
+    if (size == 0) return ranges;
+    chunks = std::clamp(chunks, 1, size);
+    const int interval = std::max(keyframeInterval, 1);
+    
+    int start = range.start;
+    for (int k = 1; k <= chunks; ++k) {
+        int end = range.end;
+        if (k < chunks) {
+            // Even split, then the nearest keyframe
+            int boundary = range.start + static_cast<int>(static_cast<int64_t>(size) * k / chunks);
+            int position = boundary + keyframeOffset;
+            boundary = (position + interval / 2) / interval * interval - keyframeOffset;
+            end = std::clamp(boundary, range.start, range.end);
+        }
+        if (end > start) {
+            ranges.push_back({start, end});
+            start = end;
+        }
+    }
+    return ranges;
+}
+
+std::string chunkPath(const std::string& outputPath, int index) {
+    char part[16];
+    std::snprintf(part, sizeof(part), ".part%03d", index);
+    
+    // stdout: chunks are staged in the temp directory, under a per-process
+    // name so that concurrent runs do not share chunk files
+    const std::string streamName = "fourier_stream_" + std::to_string(::getpid()) + ".y4m";
+    fs::path path = (outputPath == "-") ? fs::temp_directory_path() / streamName
+                                        : fs::path(outputPath);
+    fs::path name = path.stem();
+    name += part;
+    name += path.extension();
+    return (path.parent_path() / name).string();
+}
+
+bool concatenateChunks(const std::vector<std::string>& chunks, const std::string& outputPath,
+                       OutputFormat format, std::string* errorMessage) {
+    FOURIER_PROFILE_SCOPE("concatenateChunks");
+    if (isImageSequence(format)) return true;
+    if (chunks.empty()) return fail(errorMessage, "No chunks to merge");
+    
+    if (format == OutputFormat::Container) {
+        std::vector<ConcatEntry> entries;
+        for (const auto& chunk : chunks) {
+            entries.push_back({chunk, 0.0});
+        }
+        return concatenateContainers(entries, outputPath, errorMessage);
+    }
+    return concatenateStreams(chunks, outputPath, format == OutputFormat::Y4M, errorMessage);
+}
+
+ChunkedRenderer::ChunkedRenderer(int numChunks)
+    : numChunks(std::max(numChunks, 1)) {}
+
+void ChunkedRenderer::initialize(const std::vector<std::vector<FourierCoefficient>>& chains,
+                                 const AnimationConfig& animConfig, const VideoConfig& videoConfig) {
+    this->chains = chains;
+    this->animConfig = animConfig;
+    this->videoConfig = videoConfig;
+}
+
+bool ChunkedRenderer::renderChunk(const std::vector<std::vector<FourierCoefficient>>& chains,
+                                  const AnimationConfig& animConfig, const VideoConfig& videoConfig,
+                                  const FrameRange& range, std::string* errorMessage) {
+    AnimationEngine engine;
+    engine.initialize(chains, animConfig);
+    
+    VideoWriter writer;
+    if (!writer.open(videoConfig)) {
+        return fail(errorMessage, "Failed to open " + videoConfig.outputPath);
+    }
+    
+    // Holds belong to the chunks holding the first and last frames
+    cv::Mat lastFrame;
+    for (int frame = range.start; frame < range.end; ++frame) {
+        cv::Mat image = engine.renderFrame(frame);
+        if (image.empty()) {
+            return fail(errorMessage, "Failed to render frame " + std::to_string(frame));
+        }
+        if (frame == 0) {
+            writer.writeHold(image, videoConfig.holdFrames(videoConfig.introHoldSeconds));
+        }
+        if (!writer.writeFrame(image)) {
+            return fail(errorMessage, "Output failed at frame " + std::to_string(frame));
+        }
+        if (frame == animConfig.totalFrames - 1) {
+            lastFrame = image;
+        }
+    }
+    if (!lastFrame.empty()) {
+        writer.writeHold(lastFrame, videoConfig.holdFrames(videoConfig.endHoldSeconds));
+        lastFrame.release();
+    }
+    
+    writer.release();
+    return true;
+}
+
+ChunkedRenderStats ChunkedRenderer::render(const FrameRange& range) {
+    using Clock = std::chrono::steady_clock;
+    
+    ChunkedRenderStats stats;
+    const FrameRange clamped = clampFrameRange(range, animConfig.totalFrames);
+    const OutputFormat format = resolveOutputFormat(videoConfig);
+    const int introFrames = videoConfig.holdFrames(videoConfig.introHoldSeconds);
+    const auto ranges = splitFrameRange(clamped, numChunks, videoConfig.keyframeFrames(), introFrames);
+    
+    stats.chunks = static_cast<int>(ranges.size());
+    stats.frames = clamped.size();
+    if (ranges.empty()) {
+        stats.errorMessage = "Empty frame range";
+        return stats;
+    }
+    
+    // Sequences write straight to their files; other outputs go to one
+    // file per chunk unless there is a single chunk (not for stdout: the
+    // chunks must be complete before any of them is streamed)
+    const bool merge = !isImageSequence(format) && (ranges.size() > 1 || videoConfig.outputPath == "-");
+    std::vector<VideoConfig> configs(ranges.size(), videoConfig);
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        configs[i].format = format;
+        configs[i].firstFileIndex = videoConfig.outputIndex(ranges[i].start);
+        if (merge) {
+            configs[i].outputPath = chunkPath(videoConfig.outputPath, static_cast<int>(i));
+            paths.push_back(configs[i].outputPath);
+        }
+        std::cout << "[ChunkedRenderer] Chunk " << i << ": frames " << ranges[i].start
+                  << "-" << ranges[i].end - 1 << " -> " << configs[i].outputPath << std::endl;
+    }
+    
+    // One thread, engine and encoder per chunk
+    auto start = Clock::now();
+    std::vector<std::string> errors(ranges.size());
+    std::vector<char> succeeded(ranges.size(), 0);
+    std::vector<std::thread> workers;
+    workers.reserve(ranges.size());
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        workers.emplace_back([&, i] {
+            succeeded[i] = renderChunk(chains, animConfig, configs[i], ranges[i], &errors[i]);
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    stats.wallSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        if (!succeeded[i]) {
+            stats.errorMessage = "Chunk " + std::to_string(i) + ": " + errors[i];
+            return stats;
+        }
+    }
+    
+    if (merge) {
+        auto mergeStart = Clock::now();
+        if (!concatenateChunks(paths, videoConfig.outputPath, format, &stats.errorMessage)) {
+            std::cerr << "[ChunkedRenderer] Merge failed, chunks kept" << std::endl;
+            return stats;
+        }
+        stats.mergeSeconds = std::chrono::duration<double>(Clock::now() - mergeStart).count();
+        
+        std::error_code ec;
+        for (const auto& path : paths) {
+            fs::remove(path, ec);
+        }
+    }
+    
+    stats.success = true;
+    return stats;
+}
+
+} // namespace fourier
@@ -0,0 +1,427 @@
+#include "coefficient_cache.hpp"
+#include "profiler.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace fourier {
+
+static_assert(std::endian::native == std::endian::little,
+              "Coefficient files are read in place as little-endian");
+
+namespace {
+
+// On-disk layout (see coefficient_cache.hpp)
+struct FileHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t flags;
+    uint32_t chainCount;
+    uint32_t reserved;
+};
+static_assert(sizeof(FileHeader) == 16);
+
+struct TermRecord {
+    int32_t frequency;
+    int32_t reserved;
+    double re;
+    double im;
+};
+static_assert(sizeof(TermRecord) == 24);
+
+struct HalfTermRecord {
+    int32_t frequency;
+    uint16_t re;
+    uint16_t im;
+};
+static_assert(sizeof(HalfTermRecord) == 8);
+
+constexpr char kMagic[4] = {'F', 'C', 'O', 'F'};
+constexpr const char* kEntryExtension = ".fcof";
+constexpr const char* kTemporaryInfix = ".fcof.tmp";   // <entry>.tmp<pid>.<thread>
+constexpr auto kStaleTemporaryAge = std::chrono::hours(1);
+
+uint64_t align8(uint64_t bytes) {
+    return (bytes + 7) & ~uint64_t(7);
+}
+
+// IEEE 754 binary16, round to nearest even
+uint16_t toHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint32_t sign = (bits >> 16) & 0x8000;
+    const uint32_t biased = (bits >> 23) & 0xff;
+    uint32_t mantissa = bits & 0x7fffff;
+    
+    if (biased == 0xff) {
+        return static_cast<uint16_t>(sign | 0x7c00 | (mantissa ? 0x200 : 0));  // Inf, NaN
+    }
+    const int exponent = static_cast<int>(biased) - 127 + 15;
+    if (exponent >= 31) {
+        return static_cast<uint16_t>(sign | 0x7c00);  // Overflow to infinity
+    }
+    if (exponent <= 0) {
+        // Subnormal (or zero)
+        if (exponent < -10) return static_cast<uint16_t>(sign);
+        mantissa |= 0x800000;
+        const uint32_t shift = static_cast<uint32_t>(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        const uint32_t rest = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1))) half++;
+        return static_cast<uint16_t>(sign | half);
+    }
+    uint32_t half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    const uint32_t rest = mantissa & 0x1fff;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) half++;  // A carry rounds up the exponent
+    return static_cast<uint16_t>(sign | half);
+}
+
+float fromHalf(uint16_t half) {
+    const uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1f;
+    uint32_t mantissa = half & 0x3ff;
+    uint32_t bits;
+    
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else {
+            // Subnormal: normalize
+            exponent = 127 - 15 + 1;
+            while (!(mantissa & 0x400)) {
+                mantissa <<= 1;
+                exponent--;
+            }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+        }
+    } else if (exponent == 31) {
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    }
+    
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// 64-bit FNV-1a
+constexpr uint64_t kFnvOffset = 14695981039346656037ull;
+constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+void hashBytes(uint64_t& hash, const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= kFnvPrime;
+    }
+}
+
+template <typename T>
+void hashValue(uint64_t& hash, T value) {
+    hashBytes(hash, &value, sizeof(value));
+}
+
+bool fail(std::string* errorMessage, const std::string& message) {
+    if (errorMessage) *errorMessage = message;
+    return false;
+}
+
+// Decode a whole file image (mapped or in memory)
+bool parseCoefficients(const uint8_t* data, uint64_t size, CoefficientChains& chains,
+                       std::string* errorMessage) {
+    FileHeader header;
+    if (size < sizeof(header)) return fail(errorMessage, "Truncated coefficient file");
+    std::memcpy(&header, data, sizeof(header));
+    
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        return fail(errorMessage, "Not a coefficient file");
+    }
+    if (header.version != kCoefficientFileVersion) {
+        return fail(errorMessage, "Unsupported coefficient file version " + std::to_string(header.version));
+    }
+    if (header.flags & ~kCoefficientHalf) {
+        return fail(errorMessage, "Unknown coefficient file flags");
+    }
+    
+    const bool half = header.flags & kCoefficientHalf;
+    const uint64_t recordSize = half ? sizeof(HalfTermRecord) : sizeof(TermRecord);
+    uint64_t offset = sizeof(header) + align8(uint64_t(4) * header.chainCount);
+    if (offset > size) return fail(errorMessage, "Truncated coefficient file");
+    
+    std::vector<uint32_t> counts(header.chainCount);
+    std::memcpy(counts.data(), data + sizeof(header), counts.size() * sizeof(uint32_t));
+    uint64_t totalTerms = 0;
+    for (uint32_t count : counts) totalTerms += count;
+    if (totalTerms > size / recordSize || offset + totalTerms * recordSize != size) {
+        return fail(errorMessage, "Coefficient file size does not match its term counts");
+    }
+    
+    chains.assign(header.chainCount, {});
+    for (uint32_t c = 0; c < header.chainCount; ++c) {
+        auto& chain = chains[c];
+        chain.resize(counts[c]);
+        
+        for (auto& coef : chain) {
+            if (half) {
+                HalfTermRecord record;
+                std::memcpy(&record, data + offset, sizeof(record));
+                coef.frequency = record.frequency;
+                coef.cn = {fromHalf(record.re), fromHalf(record.im)};
+            } else {
+                TermRecord record;
+                std::memcpy(&record, data + offset, sizeof(record));
+                coef.frequency = record.frequency;
+                coef.cn = {record.re, record.im};
+            }
+            coef.amplitude = std::abs(coef.cn);
+            coef.phase = std::arg(coef.cn);
+            offset += recordSize;
+        }
+        
+        // float16 rounding can swap near-equal amplitudes; ties keep file order
+        std::stable_sort(chain.begin(), chain.end(),
+                         [](const FourierCoefficient& a, const FourierCoefficient& b) {
+                             return a.amplitude > b.amplitude;
+                         });
+        assignColors(chain);
+    }
+    return true;
+}
+
+} // namespace
+
+bool saveCoefficients(const std::string& path, const CoefficientChains& chains,
+                      bool halfPrecision) {
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kCoefficientFileVersion;
+    header.flags = halfPrecision ? kCoefficientHalf : 0;
+    header.chainCount = static_cast<uint32_t>(chains.size());
+    
+    // Build the file in memory and write it at once
+    const uint64_t tableBytes = align8(uint64_t(4) * chains.size());
+    const uint64_t recordSize = halfPrecision ? sizeof(HalfTermRecord) : sizeof(TermRecord);
+    uint64_t totalTerms = 0;
+    for (const auto& chain : chains) totalTerms += chain.size();
+    
+    std::vector<uint8_t> bytes(sizeof(header) + tableBytes + totalTerms * recordSize, 0);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    
+    uint64_t offset = sizeof(header);
+    for (const auto& chain : chains) {
+        uint32_t count = static_cast<uint32_t>(chain.size());
+        std::memcpy(bytes.data() + offset, &count, sizeof(count));
+        offset += sizeof(count);
+    }
+    
+    offset = sizeof(header) + tableBytes;
+    for (const auto& chain : chains) {
+        for (const auto& coef : chain) {
+            if (halfPrecision) {
+                HalfTermRecord record{coef.frequency,
+                                      toHalf(static_cast<float>(coef.cn.real())),
+                                      toHalf(static_cast<float>(coef.cn.imag()))};
+                std::memcpy(bytes.data() + offset, &record, sizeof(record));
+            } else {
+                TermRecord record{coef.frequency, 0, coef.cn.real(), coef.cn.imag()};
+                std::memcpy(bytes.data() + offset, &record, sizeof(record));
+            }
+            offset += recordSize;
+        }
+    }
+    
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "[CoefficientCache] Cannot write " << path << std::endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return static_cast<bool>(file);
+}
+
+bool loadCoefficients(const std::string& path, CoefficientChains& chains,
+                      std::string* errorMessage) {
+    FOURIER_PROFILE_SCOPE("loadCoefficients");
+    
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return fail(errorMessage, "Cannot open coefficient file: " + path);
+    
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(FileHeader))) {
+        ::close(fd);
+        return fail(errorMessage, "Truncated coefficient file: " + path);
+    }
+    
+    const size_t size = static_cast<size_t>(info.st_size);
+    void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) return fail(errorMessage, "Cannot map coefficient file: " + path);
+    
+    bool ok = parseCoefficients(static_cast<const uint8_t*>(mapped), size, chains, errorMessage);
+    ::munmap(mapped, size);
+    return ok;
+}
+
+CoefficientCache::CoefficientCache(const std::string& directory, uint64_t maxBytes)
+    : directory(directory), maxBytes(maxBytes) {
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    if (ec) {
+        std::cerr << "[CoefficientCache] Cannot create " << directory << ": " << ec.message() << std::endl;
+    }
+}
+
+uint64_t CoefficientCache::key(const std::string& imagePath, const ContourConfig& contourConfig,
+                               const DFTOptions& dftOptions, int maxContours) {
+    FOURIER_PROFILE_SCOPE("CoefficientCache.key");
+    
+    std::ifstream file(imagePath, std::ios::binary);
+    if (!file.is_open()) return 0;
+    
+    uint64_t hash = kFnvOffset;
+    std::vector<char> chunk(1 << 16);
+    while (file) {
+        file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        hashBytes(hash, chunk.data(), static_cast<size_t>(file.gcount()));
+    }
+    
+    // Everything that changes the spectra; field by field (no padding bytes)
+    hashValue(hash, kCoefficientFileVersion);
+    hashValue(hash, contourConfig.cannyThreshold1);
+    hashValue(hash, contourConfig.cannyThreshold2);
+    hashValue(hash, contourConfig.blurSize);
+    hashValue(hash, contourConfig.numSamplePoints);
+    hashValue(hash, static_cast<uint8_t>(contourConfig.useAdaptiveThreshold));
+    hashValue(hash, contourConfig.adaptiveBlockSize);
+    hashValue(hash, contourConfig.adaptiveC);
+    hashValue(hash, static_cast<int>(contourConfig.selectBy));
+    hashValue(hash, static_cast<uint8_t>(contourConfig.mergeNested));
+    hashValue(hash, static_cast<int>(dftOptions.sizePolicy));
+    hashValue(hash, static_cast<uint8_t>(dftOptions.singlePrecision));
+    hashValue(hash, maxContours);
+    
+    return hash == 0 ? 1 : hash;
+}
+
+std::string CoefficientCache::entryPath(uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+    return (fs::path(directory) / (std::string(name) + kEntryExtension)).string();
+}
+
+bool CoefficientCache::load(uint64_t key, CoefficientChains& spectra) {
+    const std::string path = entryPath(key);
+    std::error_code ec;
+    if (key == 0 || !fs::exists(path, ec)) {
+        count(&CoefficientCacheStats::misses);
+        return false;
+    }
+    
+    std::string error;
+    if (!loadCoefficients(path, spectra, &error)) {
+        std::cerr << "[CoefficientCache] Dropping unreadable entry: " << error << std::endl;
+        fs::remove(path, ec);
+        count(&CoefficientCacheStats::misses);
+        return false;
+    }
+    
+    // Recently used: eviction goes by modification time
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    count(&CoefficientCacheStats::hits);
+    return true;
+}
+
+bool CoefficientCache::store(uint64_t key, const CoefficientChains& spectra) {
+    if (key == 0) return false;
+    
+    // Write aside and rename, so readers never see a partial entry; the
+    // temporary name is unique per process and thread, since batch workers
+    // sharing this cache may store the same key at once
+    const std::string path = entryPath(key);
+    const size_t thread = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    const std::string temporary = path + kTemporaryInfix + std::to_string(::getpid()) +
+                                  "." + std::to_string(thread);
+    if (!saveCoefficients(temporary, spectra)) return false;
+    
+    std::error_code ec;
+    fs::rename(temporary, path, ec);
+    if (ec) {
+        fs::remove(temporary, ec);
+        return false;
+    }
+    
+    count(&CoefficientCacheStats::stores);
+    evict();
+    return true;
+}
+
+void CoefficientCache::evict() {
+    struct Entry {
+        fs::path path;
+        fs::file_time_type lastUse;
+        uint64_t bytes;
+    };
+    std::vector<Entry> entries;
+    uint64_t totalBytes = 0;
+    
+    // Temporary files left by a store that never finished (a crashed or
+    // killed process) are removed once stale; younger ones may still be
+    // in flight and only count toward the size
+    const auto staleBefore = fs::file_time_type::clock::now() - kStaleTemporaryAge;
+    
+    std::error_code ec;
+    for (const auto& item : fs::directory_iterator(directory, ec)) {
+        const bool temporary = item.path().filename().string().find(kTemporaryInfix) !=
+                               std::string::npos;
+        if (!temporary && item.path().extension() != kEntryExtension) continue;
+        std::error_code entryError;
+        Entry entry{item.path(), item.last_write_time(entryError), item.file_size(entryError)};
+        if (entryError) continue;
+        if (temporary && entry.lastUse < staleBefore) {
+            if (fs::remove(entry.path, entryError)) count(&CoefficientCacheStats::evictions);
+            continue;
+        }
+        totalBytes += entry.bytes;
+        if (!temporary) entries.push_back(std::move(entry));
+    }
+    if (totalBytes <= maxBytes) return;
+    
+    // Oldest first
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) { return a.lastUse < b.lastUse; });
+    for (const auto& entry : entries) {
+        if (totalBytes <= maxBytes) break;
+        if (fs::remove(entry.path, ec)) {
+            totalBytes -= entry.bytes;
+            count(&CoefficientCacheStats::evictions);
+        }
+    }
+}
+
+CoefficientCacheStats CoefficientCache::getStats() const {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return stats;
+}
+
+void CoefficientCache::count(int CoefficientCacheStats::* counter) {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    ++(stats.*counter);
+}
+
+} // namespace fourier
@@ -1,9 +1,18 @@
 #include "contour_extractor.hpp"
+#include "profiler.hpp"
 #include <algorithm>
 #include <cmath>
+#include <limits>
 
 namespace fourier {
 
+namespace {
+
+// Contour counts from which selectContours measures in parallel
+constexpr int PARALLEL_METRIC_THRESHOLD = 256;
+
+} // namespace
+
 ContourResult extractContour(const std::string& imagePath, const ContourConfig& config) {
     cv::Mat image = cv::imread(imagePath, cv::IMREAD_COLOR);
     
@@ -18,56 +27,246 @@ ContourResult extractContour(const std::string& imagePath, const ContourConfig&
 }
 
 ContourResult extractContour(const cv::Mat& image, const ContourConfig& config) {
+    ContourExtractor extractor(config);
+    return extractor.extract(image);
+}
+
+MultiContourResult extractContours(const std::string& imagePath, int maxContours,
+                                   const ContourConfig& config) {
+    cv::Mat image = cv::imread(imagePath, cv::IMREAD_COLOR);
+    
+    if (image.empty()) {
+        MultiContourResult result;
+        result.success = false;
+        result.errorMessage = "Failed to load image: " + imagePath;
+        return result;
+    }
+    
+    ContourExtractor extractor(config);
+    return extractor.extractMultiple(image, maxContours);
+}
+
+ContourExtractor::ContourExtractor(const ContourConfig& config) : config(config) {}
+
+ContourResult ContourExtractor::extract(const cv::Mat& image) {
+    return extract(image, cv::Rect(0, 0, image.cols, image.rows));
+}
+
+ContourResult ContourExtractor::extract(const cv::Mat& image, const cv::Rect& roi) {
+    FOURIER_PROFILE_SCOPE("extractContour");
     ContourResult result;
     result.success = false;
     
-    cv::Mat gray;
-    if (image.channels() == 3 || image.channels() == 4) {
-        cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+    if (!detect(image, roi, result.errorMessage)) {
+        return result;
+    }
+    
+    // Largest contour, each metric computed once
+    const auto* tree = config.mergeNested ? &hierarchy : nullptr;
+    auto ranked = selectContours(contours, config.selectBy, 1, tree);
+    if (ranked.empty()) {
+        result.errorMessage = "No contours found in image";
+        return result;
+    }
+    
+    if (config.mergeNested) {
+        result.originalContour = mergeNestedContours(contours, hierarchy, ranked[0]);
     } else {
-        gray = image.clone();
+        result.originalContour = std::move(contours[ranked[0]]);
     }
     
-    // Apply Gaussian blur
-    cv::Mat blurred;
-    cv::GaussianBlur(gray, blurred, cv::Size(config.blurSize, config.blurSize), 0);
+    // Sample points uniformly
+    auto sampledContour = sampleContour(result.originalContour, config.numSamplePoints);
+    
+    // Convert to complex numbers
+    result.complexPoints = contourToComplex(sampledContour, result.centroid, result.scale);
+    result.success = true;
+    
+    return result;
+}
+
+MultiContourResult ContourExtractor::extractMultiple(const cv::Mat& image, int maxContours) {
+    FOURIER_PROFILE_SCOPE("extractContours");
+    MultiContourResult result;
+    result.success = false;
+    
+    if (!detect(image, cv::Rect(0, 0, image.cols, image.rows), result.errorMessage)) {
+        return result;
+    }
+    
+    const auto* tree = config.mergeNested ? &hierarchy : nullptr;
+    auto ranked = selectContours(contours, config.selectBy, maxContours, tree);
+    if (ranked.empty()) {
+        result.errorMessage = "No contours found in image";
+        return result;
+    }
+    
+    // Each contour is sampled on its own; all of them are then normalized
+    // by one centroid and scale so they keep their place in the image
+    std::vector<std::vector<cv::Point>> sampled;
+    sampled.reserve(ranked.size());
+    for (int index : ranked) {
+        if (config.mergeNested) {
+            result.originalContours.push_back(mergeNestedContours(contours, hierarchy, index));
+        } else {
+            result.originalContours.push_back(std::move(contours[index]));
+        }
+        sampled.push_back(sampleContour(result.originalContours.back(), config.numSamplePoints));
+    }
+    
+    std::vector<cv::Point> all;
+    for (const auto& points : sampled) {
+        all.insert(all.end(), points.begin(), points.end());
+    }
+    contourToComplex(all, result.centroid, result.scale);
+    
+    result.shapes.reserve(sampled.size());
+    for (const auto& points : sampled) {
+        std::vector<std::complex<double>> shape;
+        shape.reserve(points.size());
+        for (const auto& pt : points) {
+            shape.emplace_back((pt.x - result.centroid.x) * result.scale,
+                               (pt.y - result.centroid.y) * result.scale);
+        }
+        result.shapes.push_back(std::move(shape));
+    }
+    result.success = true;
+    
+    return result;
+}
+
+bool ContourExtractor::detect(const cv::Mat& image, const cv::Rect& roi, std::string& errorMessage) {
+    const cv::Rect area = roi & cv::Rect(0, 0, image.cols, image.rows);
+    if (area.empty()) {
+        errorMessage = "Empty search region";
+        return false;
+    }
+    
+    // The work images keep their buffers while the frame size stays the
+    // same; each stage writes only the region's view of them. Grayscale
+    // input is blurred directly (no copy).
+    gray.create(image.size(), CV_8UC1);
+    blurred.create(image.size(), CV_8UC1);
+    edges.create(image.size(), CV_8UC1);
+    
+    cv::Mat source = image(area);
+    if (image.channels() == 3 || image.channels() == 4) {
+        cv::Mat grayRegion = gray(area);
+        cv::cvtColor(source, grayRegion, cv::COLOR_BGR2GRAY);
+        source = grayRegion;
+    }
+    
+    // Apply Gaussian blur (isolated: pixels outside the region are stale)
+    cv::Mat blurredRegion = blurred(area);
+    cv::GaussianBlur(source, blurredRegion, cv::Size(config.blurSize, config.blurSize), 0, 0,
+                     cv::BORDER_REFLECT_101 | cv::BORDER_ISOLATED);
     
     // Edge detection
-    cv::Mat edges;
+    cv::Mat edgeRegion = edges(area);
     if (config.useAdaptiveThreshold) {
-        cv::adaptiveThreshold(blurred, edges, 255, 
+        cv::adaptiveThreshold(blurredRegion, edgeRegion, 255, 
             cv::ADAPTIVE_THRESH_GAUSSIAN_C, cv::THRESH_BINARY_INV,
             config.adaptiveBlockSize, config.adaptiveC);
     } else {
-        cv::Canny(blurred, edges, config.cannyThreshold1, config.cannyThreshold2);
+        cv::Canny(blurredRegion, edgeRegion, config.cannyThreshold1, config.cannyThreshold2);
     }
     
-    // Find contours
-    std::vector<std::vector<cv::Point>> contours;
-    cv::findContours(edges, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_NONE);
+    // Find contours (offset back to image coordinates); holes are only
+    // needed when they get merged
+    contours.clear();
+    if (config.mergeNested) {
+        cv::findContours(edgeRegion, contours, hierarchy, cv::RETR_CCOMP, cv::CHAIN_APPROX_NONE, area.tl());
+    } else {
+        cv::findContours(edgeRegion, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_NONE, area.tl());
+    }
     
     if (contours.empty()) {
-        result.errorMessage = "No contours found in image";
-        return result;
+        errorMessage = "No contours found in image";
+        return false;
     }
+    return true;
+}
+
+std::vector<int> selectContours(
+    const std::vector<std::vector<cv::Point>>& contours,
+    ContourMetric metric,
+    int k,
+    const std::vector<cv::Vec4i>* hierarchy
+) {
+    FOURIER_PROFILE_SCOPE("selectContours");
+    const int count = static_cast<int>(contours.size());
     
-    // Find largest contour by arc length
-    auto largestIt = std::max_element(contours.begin(), contours.end(),
-        [](const std::vector<cv::Point>& a, const std::vector<cv::Point>& b) {
-            return cv::arcLength(a, true) < cv::arcLength(b, true);
+    // One metric per contour (outer ones only when a hierarchy is given)
+    std::vector<double> sizes(count, -1.0);
+    auto measure = [&](const cv::Range& range) {
+        for (int i = range.start; i < range.end; ++i) {
+            if (hierarchy && (*hierarchy)[i][3] >= 0) continue;
+            sizes[i] = (metric == ContourMetric::Area)
+                ? std::abs(cv::contourArea(contours[i]))
+                : cv::arcLength(contours[i], true);
         }
-    );
+    };
+    if (count >= PARALLEL_METRIC_THRESHOLD) {
+        cv::parallel_for_(cv::Range(0, count), measure);
+    } else {
+        measure(cv::Range(0, count));
+    }
     
-    result.originalContour = *largestIt;
+    std::vector<int> order;
+    order.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        if (sizes[i] >= 0.0) order.push_back(i);
+    }
     
-    // Sample points uniformly
-    auto sampledContour = sampleContour(result.originalContour, config.numSamplePoints);
+    const int keep = (k <= 0) ? static_cast<int>(order.size())
+                              : std::min(k, static_cast<int>(order.size()));
+    auto larger = [&](int a, int b) { return sizes[a] > sizes[b]; };
+    std::partial_sort(order.begin(), order.begin() + keep, order.end(), larger);
+    order.resize(keep);
+    return order;
+}
+
+std::vector<cv::Point> mergeNestedContours(
+    const std::vector<std::vector<cv::Point>>& contours,
+    const std::vector<cv::Vec4i>& hierarchy,
+    int outer
+) {
+    std::vector<cv::Point> merged = contours[outer];
     
-    // Convert to complex numbers
-    result.complexPoints = contourToComplex(sampledContour, result.centroid, result.scale);
-    result.success = true;
+    for (int hole = hierarchy[outer][2]; hole >= 0; hole = hierarchy[hole][0]) {
+        const auto& inner = contours[hole];
+        if (inner.size() < 3 || merged.empty()) continue;
+        
+        // Closest pair, scanning both paths with a stride so the cost stays
+        // bounded for long outlines
+        size_t mergedStep = std::max<size_t>(1, merged.size() / 256);
+        size_t innerStep = std::max<size_t>(1, inner.size() / 256);
+        size_t at = 0, from = 0;
+        double best = std::numeric_limits<double>::max();
+        for (size_t i = 0; i < merged.size(); i += mergedStep) {
+            for (size_t j = 0; j < inner.size(); j += innerStep) {
+                double dx = merged[i].x - inner[j].x;
+                double dy = merged[i].y - inner[j].y;
+                double d = dx * dx + dy * dy;
+                if (d < best) {
+                    best = d;
+                    at = i;
+                    from = j;
+                }
+            }
+        }
+        
+        // merged[at] -> hole from inner[from] all the way round -> back
+        std::vector<cv::Point> detour;
+        detour.reserve(inner.size() + 2);
+        detour.insert(detour.end(), inner.begin() + from, inner.end());
+        detour.insert(detour.end(), inner.begin(), inner.begin() + from);
+        detour.push_back(inner[from]);
+        detour.push_back(merged[at]);
+        merged.insert(merged.begin() + at + 1, detour.begin(), detour.end());
+    }
     
-    return result;
+    return merged;
 }
 
 std::vector<cv::Point> sampleContour(const std::vector<cv::Point>& contour, int numPoints) {
@@ -0,0 +1,391 @@
+#include "epicycle_kernel.hpp"
+#include "profiler.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <numbers>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FOURIER_HAVE_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define FOURIER_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace fourier {
+
+namespace {
+
+// Cody-Waite split of pi/2 and minimax sin/cos polynomials on [-pi/4, pi/4]
+// (Cephes). theta = q * pi/2 + z with q = round(theta * 2/pi).
+constexpr double TWO_OVER_PI = 0.63661977236758134308;
+constexpr double PIO2_1 = 1.57079625129699707031;
+constexpr double PIO2_2 = 7.54978941586159635336e-8;
+constexpr double PIO2_3 = 5.39030285815811905290e-15;
+
+constexpr double SIN_C0 = 1.58962301576546568060e-10;
+constexpr double SIN_C1 = -2.50507477628578072866e-8;
+constexpr double SIN_C2 = 2.75573136213857245213e-6;
+constexpr double SIN_C3 = -1.98412698295895385996e-4;
+constexpr double SIN_C4 = 8.33333333332211858878e-3;
+constexpr double SIN_C5 = -1.66666666666666307295e-1;
+
+constexpr double COS_C0 = -1.13585365213876817300e-11;
+constexpr double COS_C1 = 2.08757008419747316778e-9;
+constexpr double COS_C2 = -2.75573141792967388112e-7;
+constexpr double COS_C3 = 2.48015872888517045348e-5;
+constexpr double COS_C4 = -1.38888888888730564116e-3;
+constexpr double COS_C5 = 4.16666666666665929218e-2;
+
+void evaluateScalar(const CoefficientSoA& soa, double t, cv::Point2d* out) {
+    const size_t n = soa.size();
+    const double* f = soa.frequency.data();
+    const double* re = soa.re.data();
+    const double* im = soa.im.data();
+    
+    double x = 0.0, y = 0.0;
+    out[0] = cv::Point2d(x, y);
+    for (size_t k = 0; k < n; ++k) {
+        double angle = f[k] * t;
+        double c = std::cos(angle);
+        double s = std::sin(angle);
+        x += re[k] * c - im[k] * s;
+        y += re[k] * s + im[k] * c;
+        out[k + 1] = cv::Point2d(x, y);
+    }
+}
+
+// Finish a block of terms computed by a SIMD kernel: scalar prefix sum
+inline void accumulate(const double* dx, const double* dy, size_t count,
+                       double& x, double& y, cv::Point2d* out) {
+    for (size_t j = 0; j < count; ++j) {
+        x += dx[j];
+        y += dy[j];
+        out[j] = cv::Point2d(x, y);
+    }
+}
+
+#ifdef FOURIER_HAVE_AVX2
+__attribute__((target("avx2,fma")))
+void evaluateAVX2(const CoefficientSoA& soa, double t, cv::Point2d* out) {
+    const size_t n = soa.size();
+    const double* f = soa.frequency.data();
+    const double* re = soa.re.data();
+    const double* im = soa.im.data();
+    
+    const __m256d vt = _mm256_set1_pd(t);
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i two = _mm256_set1_epi64x(2);
+    alignas(32) double dx[4];
+    alignas(32) double dy[4];
+    
+    double x = 0.0, y = 0.0;
+    out[0] = cv::Point2d(x, y);
+    
+    size_t k = 0;
+    for (; k + 4 <= n; k += 4) {
+        __m256d theta = _mm256_mul_pd(_mm256_loadu_pd(f + k), vt);
+        
+        // Range reduction to z in [-pi/4, pi/4], quadrant q
+        __m256d q = _mm256_round_pd(_mm256_mul_pd(theta, _mm256_set1_pd(TWO_OVER_PI)),
+                                    _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        __m256d z = _mm256_fnmadd_pd(q, _mm256_set1_pd(PIO2_1), theta);
+        z = _mm256_fnmadd_pd(q, _mm256_set1_pd(PIO2_2), z);
+        z = _mm256_fnmadd_pd(q, _mm256_set1_pd(PIO2_3), z);
+        __m256d zz = _mm256_mul_pd(z, z);
+        
+        __m256d ps = _mm256_set1_pd(SIN_C0);
+        ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(SIN_C1));
+        ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(SIN_C2));
+        ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(SIN_C3));
+        ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(SIN_C4));
+        ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(SIN_C5));
+        __m256d sinz = _mm256_fmadd_pd(_mm256_mul_pd(z, zz), ps, z);
+        
+        __m256d pc = _mm256_set1_pd(COS_C0);
+        pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(COS_C1));
+        pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(COS_C2));
+        pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(COS_C3));
+        pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(COS_C4));
+        pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(COS_C5));
+        __m256d cosz = _mm256_fmadd_pd(_mm256_mul_pd(zz, zz), pc,
+                                       _mm256_fnmadd_pd(_mm256_set1_pd(0.5), zz, _mm256_set1_pd(1.0)));
+        
+        // Quadrant fix-up: odd q swaps sin/cos, sign bits from q and q + 1
+        __m256i qi = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(q));
+        __m256d swap = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(qi, one), one));
+        __m256d sinSign = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_and_si256(qi, two), 62));
+        __m256d cosSign = _mm256_castsi256_pd(
+            _mm256_slli_epi64(_mm256_and_si256(_mm256_add_epi64(qi, one), two), 62));
+        __m256d s = _mm256_xor_pd(_mm256_blendv_pd(sinz, cosz, swap), sinSign);
+        __m256d c = _mm256_xor_pd(_mm256_blendv_pd(cosz, sinz, swap), cosSign);
+        
+        __m256d vre = _mm256_loadu_pd(re + k);
+        __m256d vim = _mm256_loadu_pd(im + k);
+        _mm256_store_pd(dx, _mm256_fmsub_pd(vre, c, _mm256_mul_pd(vim, s)));
+        _mm256_store_pd(dy, _mm256_fmadd_pd(vre, s, _mm256_mul_pd(vim, c)));
+        
+        accumulate(dx, dy, 4, x, y, out + k + 1);
+    }
+    
+    for (; k < n; ++k) {
+        double angle = f[k] * t;
+        double c = std::cos(angle);
+        double s = std::sin(angle);
+        x += re[k] * c - im[k] * s;
+        y += re[k] * s + im[k] * c;
+        out[k + 1] = cv::Point2d(x, y);
+    }
+}
+
+bool cpuHasAVX2() {
+    static const bool supported =
+        __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return supported;
+}
+#endif
+
+#ifdef FOURIER_HAVE_NEON
+void evaluateNEON(const CoefficientSoA& soa, double t, cv::Point2d* out) {
+    const size_t n = soa.size();
+    const double* f = soa.frequency.data();
+    const double* re = soa.re.data();
+    const double* im = soa.im.data();
+    
+    const float64x2_t vt = vdupq_n_f64(t);
+    const int64x2_t one = vdupq_n_s64(1);
+    const int64x2_t two = vdupq_n_s64(2);
+    double dx[2];
+    double dy[2];
+    
+    double x = 0.0, y = 0.0;
+    out[0] = cv::Point2d(x, y);
+    
+    size_t k = 0;
+    for (; k + 2 <= n; k += 2) {
+        float64x2_t theta = vmulq_f64(vld1q_f64(f + k), vt);
+        
+        // Range reduction to z in [-pi/4, pi/4], quadrant q
+        float64x2_t q = vrndnq_f64(vmulq_n_f64(theta, TWO_OVER_PI));
+        float64x2_t z = vfmsq_f64(theta, q, vdupq_n_f64(PIO2_1));
+        z = vfmsq_f64(z, q, vdupq_n_f64(PIO2_2));
+        z = vfmsq_f64(z, q, vdupq_n_f64(PIO2_3));
+        float64x2_t zz = vmulq_f64(z, z);
+        
+        float64x2_t ps = vdupq_n_f64(SIN_C0);
+        ps = vfmaq_f64(vdupq_n_f64(SIN_C1), ps, zz);
+        ps = vfmaq_f64(vdupq_n_f64(SIN_C2), ps, zz);
+        ps = vfmaq_f64(vdupq_n_f64(SIN_C3), ps, zz);
+        ps = vfmaq_f64(vdupq_n_f64(SIN_C4), ps, zz);
+        ps = vfmaq_f64(vdupq_n_f64(SIN_C5), ps, zz);
+        float64x2_t sinz = vfmaq_f64(z, vmulq_f64(z, zz), ps);
+        
+        float64x2_t pc = vdupq_n_f64(COS_C0);
+        pc = vfmaq_f64(vdupq_n_f64(COS_C1), pc, zz);
+        pc = vfmaq_f64(vdupq_n_f64(COS_C2), pc, zz);
+        pc = vfmaq_f64(vdupq_n_f64(COS_C3), pc, zz);
+        pc = vfmaq_f64(vdupq_n_f64(COS_C4), pc, zz);
+        pc = vfmaq_f64(vdupq_n_f64(COS_C5), pc, zz);
+        float64x2_t cosz = vfmaq_f64(vfmsq_f64(vdupq_n_f64(1.0), vdupq_n_f64(0.5), zz),
+                                     vmulq_f64(zz, zz), pc);
+        
+        // Quadrant fix-up: odd q swaps sin/cos, sign bits from q and q + 1
+        int64x2_t qi = vcvtq_s64_f64(q);
+        uint64x2_t swap = vceqq_s64(vandq_s64(qi, one), one);
+        uint64x2_t sinSign = vreinterpretq_u64_s64(vshlq_n_s64(vandq_s64(qi, two), 62));
+        uint64x2_t cosSign = vreinterpretq_u64_s64(
+            vshlq_n_s64(vandq_s64(vaddq_s64(qi, one), two), 62));
+        float64x2_t s = vreinterpretq_f64_u64(veorq_u64(
+            vreinterpretq_u64_f64(vbslq_f64(swap, cosz, sinz)), sinSign));
+        float64x2_t c = vreinterpretq_f64_u64(veorq_u64(
+            vreinterpretq_u64_f64(vbslq_f64(swap, sinz, cosz)), cosSign));
+        
+        float64x2_t vre = vld1q_f64(re + k);
+        float64x2_t vim = vld1q_f64(im + k);
+        vst1q_f64(dx, vfmsq_f64(vmulq_f64(vre, c), vim, s));
+        vst1q_f64(dy, vfmaq_f64(vmulq_f64(vre, s), vim, c));
+        
+        accumulate(dx, dy, 2, x, y, out + k + 1);
+    }
+    
+    for (; k < n; ++k) {
+        double angle = f[k] * t;
+        double c = std::cos(angle);
+        double s = std::sin(angle);
+        x += re[k] * c - im[k] * s;
+        y += re[k] * s + im[k] * c;
+        out[k + 1] = cv::Point2d(x, y);
+    }
+}
+#endif
+
+} // namespace
+
+CoefficientSoA CoefficientSoA::fromCoefficients(const std::vector<FourierCoefficient>& coefficients) {
+    CoefficientSoA soa;
+    soa.frequency.reserve(coefficients.size());
+    soa.re.reserve(coefficients.size());
+    soa.im.reserve(coefficients.size());
+    
+    for (const auto& coef : coefficients) {
+        soa.frequency.push_back(coef.frequency);
+        soa.re.push_back(coef.amplitude * std::cos(coef.phase));
+        soa.im.push_back(coef.amplitude * std::sin(coef.phase));
+    }
+    
+    return soa;
+}
+
+bool isKernelSupported(KernelType kernel) {
+    switch (kernel) {
+        case KernelType::Auto:
+        case KernelType::Scalar:
+        case KernelType::Table:
+            return true;
+        case KernelType::AVX2:
+#ifdef FOURIER_HAVE_AVX2
+            return cpuHasAVX2();
+#else
+            return false;
+#endif
+        case KernelType::NEON:
+#ifdef FOURIER_HAVE_NEON
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+KernelType resolveKernel(KernelType requested) {
+    if (requested == KernelType::Auto) {
+        if (isKernelSupported(KernelType::AVX2)) return KernelType::AVX2;
+        if (isKernelSupported(KernelType::NEON)) return KernelType::NEON;
+        return KernelType::Scalar;
+    }
+    return isKernelSupported(requested) ? requested : KernelType::Scalar;
+}
+
+const char* kernelName(KernelType kernel) {
+    switch (kernel) {
+        case KernelType::Auto:   return "auto";
+        case KernelType::Scalar: return "scalar";
+        case KernelType::AVX2:   return "avx2";
+        case KernelType::NEON:   return "neon";
+        case KernelType::Table:  return "table";
+    }
+    return "unknown";
+}
+
+void evaluateEpicycles(const CoefficientSoA& soa, double t,
+                       std::vector<cv::Point2d>& positions,
+                       KernelType kernel) {
+    FOURIER_PROFILE_SCOPE("evaluateEpicycles");
+    positions.resize(soa.size() + 1);
+    
+    switch (resolveKernel(kernel)) {
+        case KernelType::Table:
+            evaluateEpicycles(soa, t, positions, SineTable::shared());
+            return;
+#ifdef FOURIER_HAVE_AVX2
+        case KernelType::AVX2:
+            evaluateAVX2(soa, t, positions.data());
+            return;
+#endif
+#ifdef FOURIER_HAVE_NEON
+        case KernelType::NEON:
+            evaluateNEON(soa, t, positions.data());
+            return;
+#endif
+        default:
+            evaluateScalar(soa, t, positions.data());
+            return;
+    }
+}
+
+SineTable::SineTable(int log2Size) {
+    log2Size = std::clamp(log2Size, MIN_LOG2_SIZE, MAX_LOG2_SIZE);
+    const uint32_t size = 1u << log2Size;
+    mask = size - 1;
+    indexScale = size / (2.0 * std::numbers::pi);
+    
+    values.resize(size + size / 4 + 1);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = std::sin(static_cast<double>(i) / indexScale);
+    }
+}
+
+double SineTable::maxPhasorError(int log2Size) {
+    // |f - linear interpolation| <= h^2 / 8 * max|f''| per component
+    log2Size = std::clamp(log2Size, MIN_LOG2_SIZE, MAX_LOG2_SIZE);
+    const double h = 2.0 * std::numbers::pi / static_cast<double>(1u << log2Size);
+    return std::sqrt(2.0) * h * h / 8.0;
+}
+
+double SineTable::maxPhasorError() const {
+    return maxPhasorError(std::bit_width(mask));
+}
+
+double SineTable::positionErrorBound(const CoefficientSoA& soa, double scale) const {
+    return amplitudeSum(soa) * maxPhasorError() * scale;
+}
+
+int SineTable::chooseLog2Size(const CoefficientSoA& soa, double scale, double maxPixelError) {
+    // The bound depends on the size alone: no table is built per candidate
+    const double pixelsPerPhasorError = amplitudeSum(soa) * scale;
+    for (int log2Size = MIN_LOG2_SIZE; log2Size <= MAX_LOG2_SIZE; ++log2Size) {
+        if (pixelsPerPhasorError * maxPhasorError(log2Size) <= maxPixelError) {
+            return log2Size;
+        }
+    }
+    return 0;
+}
+
+double SineTable::amplitudeSum(const CoefficientSoA& soa) {
+    double sum = 0.0;
+    for (size_t k = 0; k < soa.size(); ++k) {
+        sum += std::hypot(soa.re[k], soa.im[k]);
+    }
+    return sum;
+}
+
+const SineTable& SineTable::shared() {
+    static const SineTable table(12);
+    return table;
+}
+
+void evaluateEpicycles(const CoefficientSoA& soa, double t,
+                       std::vector<cv::Point2d>& positions,
+                       const SineTable& table) {
+    FOURIER_PROFILE_SCOPE("evaluateEpicycles");
+    positions.resize(soa.size() + 1);
+    
+    const double* sine = table.values.data();
+    const uint32_t quarter = (table.mask + 1) / 4;
+    const double indexScale = table.indexScale * t;
+    
+    double x = 0.0;
+    double y = 0.0;
+    positions[0] = cv::Point2d(0.0, 0.0);
+    
+    for (size_t k = 0; k < soa.size(); ++k) {
+        // Table position of frequency * t; the integer part wraps to one period
+        double index = soa.frequency[k] * indexScale;
+        double whole = std::floor(index);
+        double frac = index - whole;
+        uint32_t i = static_cast<uint32_t>(static_cast<int64_t>(whole)) & table.mask;
+        
+        double s = sine[i] + frac * (sine[i + 1] - sine[i]);
+        double c = sine[i + quarter] + frac * (sine[i + quarter + 1] - sine[i + quarter]);
+        
+        x += soa.re[k] * c - soa.im[k] * s;
+        y += soa.re[k] * s + soa.im[k] * c;
+        positions[k + 1] = cv::Point2d(x, y);
+    }
+}
+
+} // namespace fourier
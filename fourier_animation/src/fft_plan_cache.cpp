@@ -0,0 +1,135 @@
+#include "fft_plan_cache.hpp"
+#include <kissfft.hh>
+#include <mutex>
+
+namespace fourier {
+
+namespace {
+
+// KissFFT's generic butterfly (prime factors above 5) writes to a mutable
+// scratch buffer inside the plan, so such plans must not run concurrently
+bool hasLargePrimeFactor(size_t n) {
+    for (size_t p : {2, 3, 5}) {
+        while (n > 1 && n % p == 0) n /= p;
+    }
+    return n > 1;
+}
+
+} // namespace
+
+struct FFTPlanCache::Plan {
+    std::unique_ptr<kissfft<double>> fftDouble;
+    std::unique_ptr<kissfft<float>> fftFloat;
+    bool needsLock = false;
+    std::mutex mutex;
+};
+
+FFTPlanCache& FFTPlanCache::instance() {
+    static FFTPlanCache cache;
+    return cache;
+}
+
+FFTPlanCache::FFTPlanCache() = default;
+FFTPlanCache::~FFTPlanCache() = default;
+
+std::shared_ptr<FFTPlanCache::Plan> FFTPlanCache::getPlan(size_t n, bool inverse, bool singlePrecision) {
+    const Key key{n, inverse, singlePrecision};
+    
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = plans.find(key);
+        if (it != plans.end()) {
+            hits.fetch_add(1, std::memory_order_relaxed);
+            return it->second;
+        }
+    }
+    
+    // Build outside the lock; if another thread won the race, use its plan
+    auto plan = std::make_shared<Plan>();
+    if (singlePrecision) {
+        plan->fftFloat = std::make_unique<kissfft<float>>(n, inverse);
+    } else {
+        plan->fftDouble = std::make_unique<kissfft<double>>(n, inverse);
+    }
+    plan->needsLock = hasLargePrimeFactor(n);
+    
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto [it, inserted] = plans.emplace(key, std::move(plan));
+    if (inserted) {
+        misses.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        hits.fetch_add(1, std::memory_order_relaxed);
+    }
+    return it->second;
+}
+
+void FFTPlanCache::transform(const std::complex<double>* in, std::complex<double>* out,
+                             size_t n, bool inverse) {
+    if (n == 0) return;
+    auto plan = getPlan(n, inverse, false);
+    
+    if (plan->needsLock) {
+        std::lock_guard<std::mutex> lock(plan->mutex);
+        plan->fftDouble->transform(in, out);
+    } else {
+        plan->fftDouble->transform(in, out);
+    }
+}
+
+void FFTPlanCache::transform(const std::complex<float>* in, std::complex<float>* out,
+                             size_t n, bool inverse) {
+    if (n == 0) return;
+    auto plan = getPlan(n, inverse, true);
+    
+    if (plan->needsLock) {
+        std::lock_guard<std::mutex> lock(plan->mutex);
+        plan->fftFloat->transform(in, out);
+    } else {
+        plan->fftFloat->transform(in, out);
+    }
+}
+
+FFTPlanCacheStats FFTPlanCache::getStats() const {
+    FFTPlanCacheStats stats;
+    stats.hits = hits.load(std::memory_order_relaxed);
+    stats.misses = misses.load(std::memory_order_relaxed);
+    
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    stats.plans = plans.size();
+    return stats;
+}
+
+void FFTPlanCache::clear() {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    plans.clear();
+    hits = 0;
+    misses = 0;
+}
+
+size_t nextSmoothSize(size_t n) {
+    if (n <= 1) return 1;
+    for (size_t candidate = n; ; ++candidate) {
+        size_t m = candidate;
+        for (size_t p : {2, 3, 5}) {
+            while (m % p == 0) m /= p;
+        }
+        if (m == 1) return candidate;
+    }
+}
+
+size_t nextPowerOfTwo(size_t n) {
+    size_t size = 1;
+    while (size < n) size <<= 1;
+    return size;
+}
+
+size_t chooseFFTSize(size_t n, FFTSizePolicy policy) {
+    switch (policy) {
+        case FFTSizePolicy::NextSmooth:     return nextSmoothSize(n);
+        case FFTSizePolicy::NextPowerOfTwo: return nextPowerOfTwo(n);
+        case FFTSizePolicy::Exact:          break;
+    }
+    return n;
+}
+
+} // namespace fourier
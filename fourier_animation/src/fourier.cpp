@@ -1,33 +1,90 @@
 #include "fourier.hpp"
-#include <kissfft.hh>
+#include "profiler.hpp"
 #include <algorithm>
 #include <cmath>
+#include <numbers>
+#include <numeric>
+#include <queue>
 #include <random>
 
 namespace fourier {
 
+namespace {
+
+// Resample a closed curve to a new number of points by linear interpolation
+std::vector<std::complex<double>> resampleClosed(
+    const std::vector<std::complex<double>>& points,
+    size_t size
+) {
+    const size_t n = points.size();
+    std::vector<std::complex<double>> resampled(size);
+    for (size_t j = 0; j < size; ++j) {
+        double position = static_cast<double>(j) * n / size;
+        size_t i0 = static_cast<size_t>(position);
+        double frac = position - i0;
+        resampled[j] = (1.0 - frac) * points[i0 % n] + frac * points[(i0 + 1) % n];
+    }
+    return resampled;
+}
+
+} // namespace
+
 std::vector<FourierCoefficient> computeDFT(
     const std::vector<std::complex<double>>& points,
-    int numCircles
+    int numCircles,
+    const DFTOptions& options
 ) {
-    const int N = static_cast<int>(points.size());
-    if (N == 0) return {};
+    FOURIER_PROFILE_SCOPE("computeDFT");
+    if (points.empty()) return {};
     
-    // Use KissFFT for the transform
-    kissfft<double> fft(N, false);  // false = forward transform
+    const size_t fftSize = chooseFFTSize(points.size(), options.sizePolicy);
+    std::vector<std::complex<double>> resampled;
+    if (fftSize != points.size()) {
+        resampled = resampleClosed(points, fftSize);
+    }
+    const auto& samples = resampled.empty() ? points : resampled;
+    const int N = static_cast<int>(fftSize);
     
+    // Forward transform with a cached KissFFT plan
+    auto& plans = FFTPlanCache::instance();
     std::vector<std::complex<double>> fftResult(N);
-    fft.transform(points.data(), fftResult.data());
-    
-    // Convert FFT result to FourierCoefficients
-    std::vector<FourierCoefficient> coefficients;
-    coefficients.reserve(N);
     
-    // Random generator for colors
-    std::mt19937 rng(42);
-    std::uniform_int_distribution<int> dist(0, 255);
+    if (options.singlePrecision) {
+        std::vector<std::complex<float>> in(samples.begin(), samples.end());
+        std::vector<std::complex<float>> out(N);
+        plans.transform(in.data(), out.data(), fftSize);
+        std::copy(out.begin(), out.end(), fftResult.begin());
+    } else {
+        plans.transform(samples.data(), fftResult.data(), fftSize);
+    }
     
+    // Rank bins by power (|X|^2 ranks like the normalized amplitude) and
+    // only fully sort the survivors; ties go to the lower bin so the
+    // selection is deterministic
+    std::vector<double> power(N);
     for (int i = 0; i < N; ++i) {
+        power[i] = std::norm(fftResult[i]);
+    }
+    
+    std::vector<int> order(N);
+    std::iota(order.begin(), order.end(), 0);
+    auto larger = [&power](int a, int b) {
+        return power[a] > power[b] || (power[a] == power[b] && a < b);
+    };
+    
+    const int keep = (numCircles > 0 && numCircles < N) ? numCircles : N;
+    if (keep < N) {
+        std::nth_element(order.begin(), order.begin() + keep, order.end(), larger);
+    }
+    std::sort(order.begin(), order.begin() + keep, larger);
+    
+    // Build FourierCoefficients for the kept bins only (largest first)
+    std::vector<FourierCoefficient> coefficients;
+    coefficients.reserve(keep);
+    
+    for (int rank = 0; rank < keep; ++rank) {
+        const int i = order[rank];
+        
         // Convert index to frequency (-N/2 to N/2)
         int n = (i < N/2) ? i : i - N;
         
@@ -36,24 +93,148 @@ std::vector<FourierCoefficient> computeDFT(
         coef.cn = fftResult[i] / static_cast<double>(N);  // Normalize
         coef.amplitude = std::abs(coef.cn);
         coef.phase = std::arg(coef.cn);
-        coef.color = cv::Scalar(dist(rng), dist(rng), dist(rng));
         
         coefficients.push_back(coef);
     }
     
-    // Sort by amplitude (largest first)
-    std::sort(coefficients.begin(), coefficients.end(),
-        [](const FourierCoefficient& a, const FourierCoefficient& b) {
-            return a.amplitude > b.amplitude;
+    assignColors(coefficients);
+    return coefficients;
+}
+
+void assignColors(std::vector<FourierCoefficient>& coefficients) {
+    // Random generator for colors, drawn in rank order
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> dist(0, 255);
+    
+    for (auto& coef : coefficients) {
+        int b = dist(rng);  // Separate statements: argument evaluation
+        int g = dist(rng);  // order is unspecified
+        int r = dist(rng);
+        coef.color = cv::Scalar(b, g, r);
+    }
+}
+
+
+std::vector<int> allocateCircles(
+    const std::vector<std::vector<FourierCoefficient>>& spectra,
+    int totalCircles,
+    int minPerShape
+) {
+    const size_t shapes = spectra.size();
+    std::vector<int> counts(shapes, 0);
+    if (shapes == 0) return counts;
+    
+    if (totalCircles <= 0) {
+        for (size_t i = 0; i < shapes; ++i) {
+            counts[i] = static_cast<int>(spectra[i].size());
         }
-    );
+        return counts;
+    }
     
-    // Keep only requested number of circles
-    if (numCircles > 0 && numCircles < static_cast<int>(coefficients.size())) {
-        coefficients.resize(numCircles);
+    // Guaranteed share first, so a small shape is never dropped entirely
+    const int base = std::min(std::max(minPerShape, 0), totalCircles / static_cast<int>(shapes));
+    int remaining = totalCircles;
+    for (size_t i = 0; i < shapes; ++i) {
+        counts[i] = std::min(base, static_cast<int>(spectra[i].size()));
+        remaining -= counts[i];
     }
     
-    return coefficients;
+    // k-way merge of the spectra (each sorted by amplitude): the next term
+    // is always the largest not yet taken
+    using Candidate = std::pair<double, size_t>;  // (amplitude, shape)
+    auto smaller = [](const Candidate& a, const Candidate& b) {
+        return a.first < b.first || (a.first == b.first && a.second > b.second);
+    };
+    std::priority_queue<Candidate, std::vector<Candidate>, decltype(smaller)> next(smaller);
+    for (size_t i = 0; i < shapes; ++i) {
+        if (counts[i] < static_cast<int>(spectra[i].size())) {
+            next.emplace(spectra[i][counts[i]].amplitude, i);
+        }
+    }
+    while (remaining > 0 && !next.empty()) {
+        size_t i = next.top().second;
+        next.pop();
+        counts[i]++;
+        remaining--;
+        if (counts[i] < static_cast<int>(spectra[i].size())) {
+            next.emplace(spectra[i][counts[i]].amplitude, i);
+        }
+    }
+    return counts;
+}
+
+
+std::vector<std::vector<FourierCoefficient>> computeDFTs(
+    const std::vector<std::vector<std::complex<double>>>& shapes,
+    int totalCircles,
+    const DFTOptions& options
+) {
+    FOURIER_PROFILE_SCOPE("computeDFTs");
+    std::vector<std::vector<FourierCoefficient>> spectra(shapes.size());
+    
+    // Full spectra: the split needs every shape's amplitudes. Shapes are
+    // independent (plans come from the thread-safe cache).
+    cv::parallel_for_(cv::Range(0, static_cast<int>(shapes.size())), [&](const cv::Range& range) {
+        for (int i = range.start; i < range.end; ++i) {
+            spectra[i] = computeDFT(shapes[i], 0, options);
+        }
+    });
+    
+    truncateSpectra(spectra, totalCircles);
+    return spectra;
+}
+
+void truncateSpectra(std::vector<std::vector<FourierCoefficient>>& spectra, int totalCircles) {
+    // Truncating keeps rank-order colors (a prefix of computeDFT output)
+    auto counts = allocateCircles(spectra, totalCircles);
+    for (size_t i = 0; i < spectra.size(); ++i) {
+        spectra[i].resize(counts[i]);
+    }
+}
+
+
+void smoothCoefficients(
+    std::vector<FourierCoefficient>& smoothed,
+    const std::vector<FourierCoefficient>& latest,
+    double alpha
+) {
+    FOURIER_PROFILE_SCOPE("smoothCoefficients");
+    alpha = std::clamp(alpha, 0.0, 1.0);
+    if (smoothed.empty() || alpha >= 1.0) {
+        smoothed = latest;
+        return;
+    }
+    
+    // Previous value of each frequency, sorted for binary search
+    std::vector<std::pair<int, std::complex<double>>> previous;
+    previous.reserve(smoothed.size());
+    for (const auto& coef : smoothed) {
+        previous.emplace_back(coef.frequency, coef.cn);
+    }
+    auto byFrequency = [](const auto& a, const auto& b) { return a.first < b.first; };
+    std::sort(previous.begin(), previous.end(), byFrequency);
+    
+    smoothed = latest;
+    for (auto& coef : smoothed) {
+        std::complex<double> before(0.0, 0.0);
+        auto it = std::lower_bound(previous.begin(), previous.end(),
+                                   std::make_pair(coef.frequency, before), byFrequency);
+        if (it != previous.end() && it->first == coef.frequency) {
+            before = it->second;
+        }
+        coef.cn = before + alpha * (coef.cn - before);
+        coef.amplitude = std::abs(coef.cn);
+        coef.phase = std::arg(coef.cn);
+    }
+    
+    // Largest first again; colors stay attached to ranks
+    std::stable_sort(smoothed.begin(), smoothed.end(),
+        [](const FourierCoefficient& a, const FourierCoefficient& b) {
+            return a.amplitude > b.amplitude;
+        });
+    for (size_t i = 0; i < smoothed.size(); ++i) {
+        smoothed[i].color = latest[i].color;
+    }
 }
 
 
@@ -62,19 +243,157 @@ std::vector<cv::Point2d> getEpicyclePositions(
     double t
 ) {
     std::vector<cv::Point2d> positions;
-    positions.reserve(coefficients.size() + 1);
+    getEpicyclePositions(coefficients, t, positions);
+    return positions;
+}
+
+void getEpicyclePositions(
+    const std::vector<FourierCoefficient>& coefficients,
+    double t,
+    std::vector<cv::Point2d>& positions
+) {
+    FOURIER_PROFILE_SCOPE("getEpicyclePositions");
+    positions.resize(coefficients.size() + 1);
     
     std::complex<double> current(0.0, 0.0);
-    positions.push_back(cv::Point2d(current.real(), current.imag()));
+    positions[0] = cv::Point2d(current.real(), current.imag());
     
-    for (const auto& coef : coefficients) {
+    for (size_t i = 0; i < coefficients.size(); ++i) {
+        const auto& coef = coefficients[i];
         double angle = coef.frequency * t + coef.phase;
         std::complex<double> rotation(std::cos(angle), std::sin(angle));
         current += coef.amplitude * rotation;
-        positions.push_back(cv::Point2d(current.real(), current.imag()));
+        positions[i + 1] = cv::Point2d(current.real(), current.imag());
+    }
+}
+
+
+std::vector<std::complex<double>> sampleTrajectory(
+    const std::vector<FourierCoefficient>& coefficients,
+    int samples
+) {
+    std::vector<std::complex<double>> spectrum;
+    std::vector<std::complex<double>> trajectory;
+    sampleTrajectory(coefficients, samples, spectrum, trajectory);
+    return trajectory;
+}
+
+void sampleTrajectory(
+    const std::vector<FourierCoefficient>& coefficients,
+    int samples,
+    std::vector<std::complex<double>>& spectrum,
+    std::vector<std::complex<double>>& trajectory
+) {
+    FOURIER_PROFILE_SCOPE("sampleTrajectory");
+    if (samples <= 0) {
+        trajectory.clear();
+        return;
     }
     
-    return positions;
+    // Spectrum with each kept term at its (wrapped) frequency bin; the
+    // unnormalized inverse transform is then sum_k c_k e^{i f_k t}
+    spectrum.assign(samples, std::complex<double>());
+    for (const auto& coef : coefficients) {
+        int bin = ((coef.frequency % samples) + samples) % samples;
+        spectrum[bin] += std::polar(coef.amplitude, coef.phase);
+    }
+    
+    trajectory.resize(samples);
+    FFTPlanCache::instance().transform(spectrum.data(), trajectory.data(), samples, true);
+}
+
+EpicycleEvaluator::EpicycleEvaluator(
+    const std::vector<FourierCoefficient>& coefficients,
+    int totalFrames,
+    int resyncInterval
+) {
+    reset(coefficients, totalFrames, resyncInterval);
+}
+
+void EpicycleEvaluator::reset(
+    const std::vector<FourierCoefficient>& coefficients,
+    int totalFrames,
+    int resyncInterval
+) {
+    const size_t n = coefficients.size();
+    frequencies.resize(n);
+    amplitudes.resize(n);
+    phases.resize(n);
+    for (size_t k = 0; k < n; ++k) {
+        frequencies[k] = coefficients[k].frequency;
+        amplitudes[k] = coefficients[k].amplitude;
+        phases[k] = coefficients[k].phase;
+    }
+    termRe.assign(n, 0.0);
+    termIm.assign(n, 0.0);
+    stepRe.assign(n, 1.0);
+    stepIm.assign(n, 0.0);
+    
+    this->totalFrames = std::max(totalFrames, 1);
+    this->resyncInterval = std::max(resyncInterval, 1);
+    currentFrame = -1;
+    stride = 0;
+    stepsSinceResync = 0;
+}
+
+void EpicycleEvaluator::seek(int frameIndex) {
+    // Exact evaluation, same formula as getEpicyclePositions
+    const double t = 2.0 * std::numbers::pi * static_cast<double>(frameIndex) / totalFrames;
+    for (size_t k = 0; k < frequencies.size(); ++k) {
+        double angle = frequencies[k] * t + phases[k];
+        termRe[k] = amplitudes[k] * std::cos(angle);
+        termIm[k] = amplitudes[k] * std::sin(angle);
+    }
+    currentFrame = frameIndex;
+    stepsSinceResync = 0;
+}
+
+void EpicycleEvaluator::setStride(int frames) {
+    const double dt = 2.0 * std::numbers::pi * static_cast<double>(frames) / totalFrames;
+    for (size_t k = 0; k < frequencies.size(); ++k) {
+        double angle = frequencies[k] * dt;
+        stepRe[k] = std::cos(angle);
+        stepIm[k] = std::sin(angle);
+    }
+    stride = frames;
+}
+
+void EpicycleEvaluator::evaluate(int frameIndex, std::vector<cv::Point2d>& positions) {
+    FOURIER_PROFILE_SCOPE("EpicycleEvaluator::evaluate");
+    const int delta = frameIndex - currentFrame;
+    
+    if (currentFrame < 0 || delta <= 0 || stepsSinceResync >= resyncInterval) {
+        seek(frameIndex);
+    } else if (delta != stride) {
+        setStride(delta);
+        seek(frameIndex);
+    } else {
+        // Rotate every term by its step phasor (plain complex multiply on
+        // split arrays so the loop vectorises)
+        const size_t n = frequencies.size();
+        double* re = termRe.data();
+        double* im = termIm.data();
+        const double* sre = stepRe.data();
+        const double* sim = stepIm.data();
+        for (size_t k = 0; k < n; ++k) {
+            double r = re[k] * sre[k] - im[k] * sim[k];
+            double i = re[k] * sim[k] + im[k] * sre[k];
+            re[k] = r;
+            im[k] = i;
+        }
+        currentFrame = frameIndex;
+        ++stepsSinceResync;
+    }
+    
+    // Prefix sum of the terms gives the chain of epicycle centers
+    positions.resize(frequencies.size() + 1);
+    double x = 0.0, y = 0.0;
+    positions[0] = cv::Point2d(x, y);
+    for (size_t k = 0; k < frequencies.size(); ++k) {
+        x += termRe[k];
+        y += termIm[k];
+        positions[k + 1] = cv::Point2d(x, y);
+    }
 }
 
 }
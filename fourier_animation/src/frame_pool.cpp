@@ -0,0 +1,61 @@
+#include "frame_pool.hpp"
+#include <algorithm>
+
+namespace fourier {
+
+FramePool::FramePool(int capacity) : capacity(std::max(capacity, 1)) {}
+
+void FramePool::reset(cv::Size size, int type) {
+    if (size != frameSize || type != frameType) {
+        buffers.clear();
+        nextSlot = 0;
+    }
+    frameSize = size;
+    frameType = type;
+}
+
+void FramePool::setCapacity(int capacity) {
+    this->capacity = std::max(capacity, 1);
+    if (static_cast<int>(buffers.size()) > this->capacity) {
+        buffers.resize(this->capacity);
+        nextSlot = 0;
+    }
+}
+
+bool FramePool::isFree(const cv::Mat& buffer) {
+    // The pool's own header is the only reference left
+    return buffer.u && CV_XADD(&buffer.u->refcount, 0) == 1;
+}
+
+cv::Mat FramePool::acquire(int* slot) {
+    stats.acquired++;
+    
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        size_t index = (nextSlot + i) % buffers.size();
+        if (isFree(buffers[index])) {
+            nextSlot = index + 1;
+            if (slot) *slot = static_cast<int>(index);
+            return buffers[index];
+        }
+    }
+    
+    if (static_cast<int>(buffers.size()) < capacity) {
+        buffers.emplace_back(frameSize, frameType);
+        nextSlot = 0;
+        if (slot) *slot = static_cast<int>(buffers.size() - 1);
+        return buffers.back();
+    }
+    
+    stats.overflows++;
+    if (slot) *slot = -1;
+    return cv::Mat(frameSize, frameType);
+}
+
+FramePoolStats FramePool::getStats() const {
+    FramePoolStats result = stats;
+    result.capacity = capacity;
+    result.allocated = static_cast<int>(buffers.size());
+    return result;
+}
+
+} // namespace fourier
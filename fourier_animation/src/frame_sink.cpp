@@ -0,0 +1,691 @@
+#include "frame_sink.hpp"
+#include "profiler.hpp"
+#include <opencv2/imgproc.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <utility>
+#include <unistd.h>
+
+namespace fourier {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Frame rate as a Y4M ratio; NTSC rates keep their exact 1001 divisor
+std::pair<long, long> frameRateRatio(double fps) {
+    if (fps <= 0.0) return {60, 1};
+    if (std::abs(fps - std::round(fps)) < 1e-6) return {std::lround(fps), 1};
+    long ntsc = std::lround(fps * 1.001);
+    if (std::abs(ntsc / 1.001 - fps) < 1e-3) return {ntsc * 1000, 1001};
+    return {std::lround(fps * 1000.0), 1000};
+}
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() &&
+           text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Single-quoted for the shell and for ffconcat files ('\'' for a quote)
+std::string quote(const std::string& text) {
+    std::string quoted = "'";
+    for (char c : text) {
+        if (c == '\'') quoted += "'\\''";
+        else quoted += c;
+    }
+    return quoted + "'";
+}
+
+bool ffmpegAvailable() {
+    static const bool available =
+        std::system("ffmpeg -hide_banner -version > /dev/null 2>&1") == 0;
+    return available;
+}
+
+// Containers the concat demuxer joins by stream copy, with ffmpeg installed
+bool holdsAsSegments(const VideoConfig& config) {
+    std::string extension = fs::path(config.outputPath).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    const bool joinable = extension == ".mp4" || extension == ".m4v" ||
+                          extension == ".mov" || extension == ".mkv";
+    return joinable && config.fps > 0.0 && ffmpegAvailable();
+}
+
+} // namespace
+
+bool ContainerSink::open(const VideoConfig& config) {
+    this->config = config;
+    segments.clear();
+    segmentFrames = 0;
+    segmented = holdsAsSegments(config);
+    const std::string path = segmented ? segmentPath(0) : config.outputPath;
+    
+    gstreamer = config.useHardwareEncoding;
+    if (gstreamer) {
+        // Try GStreamer pipeline for hardware encoding (Jetson)
+        if (openWriter(writer, path)) {
+            std::cout << "[VideoWriter] Opened with GStreamer hardware encoding" << std::endl;
+        } else {
+            std::cout << "[VideoWriter] GStreamer failed, falling back to FFmpeg" << std::endl;
+            gstreamer = false;
+        }
+    }
+    
+    if (!gstreamer) {
+        // Fallback to FFmpeg/software encoding
+        fourcc = cv::VideoWriter::fourcc(
+            config.codec[0], config.codec[1], config.codec[2], config.codec[3]
+        );
+        
+        if (!openWriter(writer, path)) {
+            // Try alternative codecs
+            std::vector<std::string> fallbackCodecs = {"mp4v", "XVID", "MJPG"};
+            for (const auto& codec : fallbackCodecs) {
+                fourcc = cv::VideoWriter::fourcc(codec[0], codec[1], codec[2], codec[3]);
+                if (openWriter(writer, path)) {
+                    std::cout << "[VideoWriter] Opened with codec: " << codec << std::endl;
+                    break;
+                }
+            }
+        }
+    }
+    
+    if (writer.isOpened() && segmented) {
+        segments.push_back({path, 0});
+    }
+    return writer.isOpened();
+}
+
+bool ContainerSink::openWriter(cv::VideoWriter& target, const std::string& path) {
+    const cv::Size size(config.width, config.height);
+    if (gstreamer) {
+        VideoConfig pipelineConfig = config;
+        pipelineConfig.outputPath = path;
+        target.open(VideoWriter::getGStreamerPipeline(pipelineConfig), cv::CAP_GSTREAMER, 0,
+                    config.fps, size, true);
+    } else {
+        target.open(path, fourcc, config.fps, size, true);
+    }
+    return target.isOpened();
+}
+
+bool ContainerSink::write(const cv::Mat& frame, int repeats) {
+    if (segmented && repeats > 1) {
+        return writeHold(frame, repeats);
+    }
+    
+    // Frames after a hold start the next segment
+    if (!writer.isOpened()) {
+        const std::string path = segmentPath(segments.size());
+        if (!openWriter(writer, path)) {
+            std::cerr << "[VideoWriter] Failed to open segment " << path << std::endl;
+            return false;
+        }
+        segments.push_back({path, 0});
+    }
+    
+    for (int i = 0; i < repeats; ++i) {
+        writer.write(frame);
+    }
+    segmentFrames += repeats;
+    return true;
+}
+
+// Ends the running segment and encodes the held frame once, on its own
+bool ContainerSink::writeHold(const cv::Mat& frame, int repeats) {
+    closeSegment();
+    
+    const std::string path = segmentPath(segments.size());
+    cv::VideoWriter still;
+    if (!openWriter(still, path)) {
+        std::cerr << "[VideoWriter] Failed to open segment " << path << std::endl;
+        return false;
+    }
+    still.write(frame);
+    still.release();
+    segments.push_back({path, repeats});
+    return true;
+}
+
+// A segment that got no frames (a hold right after open) is dropped
+void ContainerSink::closeSegment() {
+    if (!writer.isOpened()) return;
+    writer.release();
+    if (segmentFrames == 0 && !segments.empty()) {
+        std::error_code ec;
+        fs::remove(segments.back().path, ec);
+        segments.pop_back();
+    }
+    segmentFrames = 0;
+}
+
+void ContainerSink::close() {
+    if (!segmented) {
+        writer.release();
+        return;
+    }
+    closeSegment();
+    if (segments.empty()) return;
+    
+    // No hold (e.g. a live recording): the one segment is the video
+    std::error_code ec;
+    if (segments.size() == 1 && segments.front().holdFrames == 0) {
+        fs::rename(segments.front().path, config.outputPath, ec);
+        if (!ec) {
+            segments.clear();
+            return;
+        }
+    }
+    
+    std::vector<ConcatEntry> entries;
+    const double period = 1.0 / config.fps;
+    for (const auto& segment : segments) {
+        entries.push_back({segment.path, segment.holdFrames * period});
+    }
+    
+    // The muxer gives the last packet a single frame period, so a closing
+    // hold is listed once more to put its frame at the last period too
+    if (segments.back().holdFrames > 1) {
+        entries.back().seconds = (segments.back().holdFrames - 1) * period;
+        entries.push_back({segments.back().path, period});
+    }
+    
+    std::string error;
+    if (concatenateContainers(entries, config.outputPath, &error)) {
+        for (const auto& segment : segments) {
+            fs::remove(segment.path, ec);
+        }
+    } else {
+        std::cerr << "[VideoWriter] Joining segments failed (" << error << "), kept "
+                  << segments.size() << " segments next to " << config.outputPath << std::endl;
+    }
+    segments.clear();
+}
+
+std::string ContainerSink::segmentPath(size_t index) const {
+    char segment[16];
+    std::snprintf(segment, sizeof(segment), ".seg%03zu", index);
+    fs::path path(config.outputPath);
+    fs::path name = path.stem();
+    name += segment;
+    name += path.extension();
+    return (path.parent_path() / name).string();
+}
+
+RawStreamSink::RawStreamSink(OutputFormat format) : format(format) {}
+
+RawStreamSink::~RawStreamSink() {
+    close();
+}
+
+const char* RawStreamSink::name() const {
+    switch (format) {
+        case OutputFormat::RawBGR: return "raw BGR";
+        case OutputFormat::RawI420: return "raw I420";
+        default: return "Y4M";
+    }
+}
+
+std::string RawStreamSink::y4mHeader(const VideoConfig& config) {
+    auto [num, den] = frameRateRatio(config.fps);
+    return "YUV4MPEG2 W" + std::to_string(config.width) + " H" + std::to_string(config.height) +
+           " F" + std::to_string(num) + ":" + std::to_string(den) +
+           " Ip A1:1 C420jpeg XCOLORRANGE=LIMITED\n";
+}
+
+bool RawStreamSink::open(const VideoConfig& config) {
+    close();
+    failed = false;
+    
+    const bool yuv = format != OutputFormat::RawBGR;
+    if (yuv && (config.width % 2 != 0 || config.height % 2 != 0)) {
+        std::cerr << "[FrameSink] " << name() << " needs an even frame size, got "
+                  << config.width << "x" << config.height << std::endl;
+        return false;
+    }
+    
+    // stdout is duplicated so the stream gets its own stdio buffer
+    const bool toStdout = config.outputPath == "-";
+    if (toStdout) {
+        int fd = ::dup(STDOUT_FILENO);
+        file = (fd >= 0) ? ::fdopen(fd, "wb") : nullptr;
+        if (!file && fd >= 0) ::close(fd);
+    } else {
+        file = std::fopen(config.outputPath.c_str(), "wb");
+    }
+    if (!file) {
+        std::cerr << "[FrameSink] Cannot open " << config.outputPath << ": "
+                  << std::strerror(errno) << std::endl;
+        return false;
+    }
+    
+    buffer.resize(std::max<size_t>(config.streamBufferBytes, 64 << 10));
+    std::setvbuf(file, buffer.data(), _IOFBF, buffer.size());
+    
+    if (yuv) {
+        i420.create(config.height * 3 / 2, config.width, CV_8UC1);
+    }
+    if (format == OutputFormat::Y4M) {
+        std::string header = y4mHeader(config);
+        writeBytes(header.data(), header.size());
+    }
+    
+    std::cout << "[FrameSink] Streaming " << name() << " to "
+              << (toStdout ? "stdout" : config.outputPath) << std::endl;
+    return !failed;
+}
+
+bool RawStreamSink::write(const cv::Mat& frame, int repeats) {
+    FOURIER_PROFILE_SCOPE("FrameSink.write");
+    if (!file || failed) return false;
+    
+    // Bytes of one frame, converted once however often it is shown
+    const cv::Mat* data = &frame;
+    if (format == OutputFormat::RawBGR) {
+        if (!frame.isContinuous()) {
+            frame.copyTo(staging);
+            data = &staging;
+        }
+    } else {
+        FOURIER_PROFILE_SCOPE("FrameSink.toI420");
+        cv::cvtColor(frame, i420, cv::COLOR_BGR2YUV_I420);
+        data = &i420;
+    }
+    const size_t size = data->total() * data->elemSize();
+    
+    static const char FRAME_TAG[] = "FRAME\n";
+    for (int i = 0; i < repeats && !failed; ++i) {
+        if (format == OutputFormat::Y4M) {
+            writeBytes(FRAME_TAG, sizeof(FRAME_TAG) - 1);
+        }
+        writeBytes(data->data, size);
+    }
+    return !failed;
+}
+
+void RawStreamSink::close() {
+    if (!file) return;
+    if (std::fclose(file) != 0) failed = true;
+    file = nullptr;
+}
+
+bool RawStreamSink::writeBytes(const void* data, size_t size) {
+    if (std::fwrite(data, 1, size, file) != size) {
+        if (!failed) {
+            std::cerr << "[FrameSink] Write failed: " << std::strerror(errno) << std::endl;
+        }
+        failed = true;
+    }
+    return !failed;
+}
+
+ImageSequenceSink::ImageSequenceSink(OutputFormat format) : format(format) {}
+
+ImageSequenceSink::~ImageSequenceSink() {
+    close();
+}
+
+const char* ImageSequenceSink::name() const {
+    return format == OutputFormat::QoiSequence ? "QOI sequence" : "PNG sequence";
+}
+
+std::string ImageSequenceSink::fileName(const std::string& pattern, int index) {
+    // Only %d / %0Nd is accepted (the pattern is never used as a format string)
+    size_t start = pattern.find('%');
+    if (start == std::string::npos) return {};
+    size_t pos = start + 1;
+    bool zeroPad = pos < pattern.size() && pattern[pos] == '0';
+    if (zeroPad) ++pos;
+    size_t width = 0;
+    while (pos < pattern.size() && std::isdigit(static_cast<unsigned char>(pattern[pos]))) {
+        width = width * 10 + (pattern[pos] - '0');
+        ++pos;
+    }
+    if (pos >= pattern.size() || pattern[pos] != 'd' || width > 16) return {};
+    if (pattern.find('%', pos) != std::string::npos) return {};
+    
+    std::string number = std::to_string(index);
+    if (number.size() < width) {
+        number.insert(0, width - number.size(), zeroPad ? '0' : ' ');
+    }
+    return pattern.substr(0, start) + number + pattern.substr(pos + 1);
+}
+
+void ImageSequenceSink::encodeQoi(const cv::Mat& image, std::vector<uint8_t>& out) {
+    const int width = image.cols;
+    const int height = image.rows;
+    out.clear();
+    out.reserve(static_cast<size_t>(width) * height * 4 + 22);
+    
+    auto put32 = [&out](uint32_t v) {
+        out.push_back(static_cast<uint8_t>(v >> 24));
+        out.push_back(static_cast<uint8_t>(v >> 16));
+        out.push_back(static_cast<uint8_t>(v >> 8));
+        out.push_back(static_cast<uint8_t>(v));
+    };
+    out.insert(out.end(), {'q', 'o', 'i', 'f'});
+    put32(static_cast<uint32_t>(width));
+    put32(static_cast<uint32_t>(height));
+    out.push_back(3);  // RGB
+    out.push_back(0);  // sRGB
+    
+    // Opaque pixels only: every alpha is 255, so QOI_OP_RGBA is never needed
+    struct Rgb { uint8_t r, g, b; };
+    Rgb index[64] = {};
+    bool indexUsed[64] = {};
+    Rgb prev{0, 0, 0};
+    int run = 0;
+    const size_t last = static_cast<size_t>(width) * height - 1;
+    size_t position = 0;
+    
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* row = image.ptr<uint8_t>(y);
+        for (int x = 0; x < width; ++x, ++position) {
+            const Rgb px{row[3 * x + 2], row[3 * x + 1], row[3 * x]};
+            
+            if (px.r == prev.r && px.g == prev.g && px.b == prev.b) {
+                if (++run == 62 || position == last) {
+                    out.push_back(static_cast<uint8_t>(0xc0 | (run - 1)));  // QOI_OP_RUN
+                    run = 0;
+                }
+                continue;
+            }
+            if (run > 0) {
+                out.push_back(static_cast<uint8_t>(0xc0 | (run - 1)));
+                run = 0;
+            }
+            
+            const int hash = (px.r * 3 + px.g * 5 + px.b * 7 + 255 * 11) % 64;
+            const Rgb& cached = index[hash];
+            if (indexUsed[hash] && cached.r == px.r && cached.g == px.g && cached.b == px.b) {
+                out.push_back(static_cast<uint8_t>(hash));  // QOI_OP_INDEX
+            } else {
+                index[hash] = px;
+                indexUsed[hash] = true;
+                
+                const int vr = static_cast<int8_t>(px.r - prev.r);
+                const int vg = static_cast<int8_t>(px.g - prev.g);
+                const int vb = static_cast<int8_t>(px.b - prev.b);
+                const int vgr = vr - vg;
+                const int vgb = vb - vg;
+                if (vr >= -2 && vr <= 1 && vg >= -2 && vg <= 1 && vb >= -2 && vb <= 1) {
+                    out.push_back(static_cast<uint8_t>(0x40 | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2)));
+                } else if (vgr >= -8 && vgr <= 7 && vg >= -32 && vg <= 31 && vgb >= -8 && vgb <= 7) {
+                    out.push_back(static_cast<uint8_t>(0x80 | (vg + 32)));  // QOI_OP_LUMA
+                    out.push_back(static_cast<uint8_t>((vgr + 8) << 4 | (vgb + 8)));
+                } else {
+                    out.insert(out.end(), {0xfe, px.r, px.g, px.b});  // QOI_OP_RGB
+                }
+            }
+            prev = px;
+        }
+    }
+    out.insert(out.end(), {0, 0, 0, 0, 0, 0, 0, 1});
+}
+
+bool ImageSequenceSink::open(const VideoConfig& videoConfig) {
+    close();
+    config = videoConfig;
+    failed = false;
+    stopping = false;
+    nextIndex = config.firstFileIndex;
+    manifest.clear();
+    previous.release();
+    
+    if (fileName(config.outputPath, 0).empty()) {
+        std::cerr << "[FrameSink] Image sequence path needs a %d or %0Nd pattern: "
+                  << config.outputPath << std::endl;
+        return false;
+    }
+    std::error_code error;
+    fs::path directory = fs::path(config.outputPath).parent_path();
+    if (!directory.empty()) {
+        fs::create_directories(directory, error);
+    }
+    
+    const int threads = config.sequenceThreads > 0
+        ? config.sequenceThreads
+        : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const int inFlight = config.sequenceInFlight > 0 ? config.sequenceInFlight : 2 * threads;
+    
+    // Full-size buffers up front: a frame (or its changed box) is copied
+    // into a free one, so nothing is allocated per frame
+    slots.assign(inFlight, cv::Mat());
+    freeSlots.clear();
+    for (int i = 0; i < inFlight; ++i) {
+        slots[i].create(config.height, config.width, CV_8UC3);
+        freeSlots.push_back(i);
+    }
+    
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back([this] { workerLoop(); });
+    }
+    
+    std::cout << "[FrameSink] Writing " << name() << " " << config.outputPath << " ("
+              << threads << " threads, " << inFlight << " frames in flight"
+              << (config.sequenceCropChanges ? ", changed regions only" : "") << ")" << std::endl;
+    return true;
+}
+
+bool ImageSequenceSink::write(const cv::Mat& frame, int repeats) {
+    FOURIER_PROFILE_SCOPE("FrameSink.write");
+    if (workers.empty() || failed) return false;
+    
+    // Region to store: the whole frame, or the box of pixels that changed
+    cv::Rect rect(0, 0, frame.cols, frame.rows);
+    if (config.sequenceCropChanges) {
+        FOURIER_PROFILE_SCOPE("FrameSink.diff");
+        if (!previous.empty()) {
+            cv::absdiff(frame, previous, difference);
+            // Channels side by side: x of the box is in bytes
+            cv::Rect bytes = cv::boundingRect(difference.reshape(1));
+            rect = bytes.empty()
+                ? cv::Rect()
+                : cv::Rect(bytes.x / 3, bytes.y, (bytes.br().x - 1) / 3 - bytes.x / 3 + 1, bytes.height);
+        }
+        frame.copyTo(previous);
+        
+        // Frames of a hold after the first are unchanged
+        for (int i = 0; i < repeats; ++i) {
+            manifest.push_back({nextIndex + i, i == 0 ? rect : cv::Rect()});
+        }
+        if (rect.empty()) {
+            nextIndex += repeats;
+            return true;
+        }
+    }
+    
+    int slot;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        slotFree.wait(lock, [this] { return !freeSlots.empty() || failed; });
+        if (failed) return false;
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    frame(rect).copyTo(slots[slot](cv::Rect(0, 0, rect.width, rect.height)));
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back({slot, nextIndex, config.sequenceCropChanges ? 1 : repeats, rect});
+    }
+    jobReady.notify_one();
+    nextIndex += repeats;
+    return true;
+}
+
+void ImageSequenceSink::workerLoop() {
+    std::vector<uint8_t> encoded;  // Reused across frames
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobReady.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty()) return;
+            job = jobs.front();
+            jobs.pop_front();
+        }
+        
+        cv::Mat image = slots[job.slot](cv::Rect(0, 0, job.rect.width, job.rect.height));
+        bool ok = !failed && compress(image, encoded);
+        
+        // A hold is compressed once and written under each index
+        for (int i = 0; ok && i < job.repeats; ++i) {
+            std::string path = fileName(config.outputPath, job.firstIndex + i);
+            std::FILE* file = std::fopen(path.c_str(), "wb");
+            ok = file && std::fwrite(encoded.data(), 1, encoded.size(), file) == encoded.size();
+            if (file && std::fclose(file) != 0) ok = false;
+            if (!ok) {
+                std::cerr << "[FrameSink] Cannot write " << path << std::endl;
+            }
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!ok) failed = true;
+            freeSlots.push_back(job.slot);
+        }
+        slotFree.notify_one();
+    }
+}
+
+bool ImageSequenceSink::compress(const cv::Mat& image, std::vector<uint8_t>& out) const {
+    FOURIER_PROFILE_SCOPE("FrameSink.compress");
+    if (format == OutputFormat::QoiSequence) {
+        encodeQoi(image, out);
+        return true;
+    }
+    return cv::imencode(".png", image, out, {cv::IMWRITE_PNG_COMPRESSION, config.pngCompression});
+}
+
+void ImageSequenceSink::close() {
+    if (workers.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    
+    if (config.sequenceCropChanges && !failed) {
+        writeManifest();
+    }
+    std::cout << "[FrameSink] " << nextIndex - config.firstFileIndex << " frames written to "
+              << config.outputPath << std::endl;
+}
+
+void ImageSequenceSink::writeManifest() const {
+    // Chunks of a sharded render each list their own frames
+    std::string name = config.firstFileIndex > 0
+        ? "manifest_" + std::to_string(config.firstFileIndex) + ".json" : "manifest.json";
+    fs::path path = fs::path(config.outputPath).parent_path() / name;
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "[FrameSink] Failed to write " << path.string() << std::endl;
+        return;
+    }
+    
+    // Files are named relative to the manifest; an unchanged frame has none
+    out << "{\n  \"width\": " << config.width << ", \"height\": " << config.height
+        << ", \"fps\": " << config.fps << ",\n  \"frames\": [\n";
+    for (size_t i = 0; i < manifest.size(); ++i) {
+        const auto& entry = manifest[i];
+        out << "    {\"index\": " << entry.index << ", \"file\": ";
+        if (entry.rect.empty()) {
+            out << "null";
+        } else {
+            out << "\"" << fs::path(fileName(config.outputPath, entry.index)).filename().string() << "\"";
+        }
+        out << ", \"x\": " << entry.rect.x << ", \"y\": " << entry.rect.y
+            << ", \"width\": " << entry.rect.width << ", \"height\": " << entry.rect.height << "}"
+            << (i + 1 < manifest.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+bool isImageSequence(OutputFormat format) {
+    return format == OutputFormat::PngSequence || format == OutputFormat::QoiSequence;
+}
+
+OutputFormat resolveOutputFormat(const VideoConfig& config) {
+    if (config.format != OutputFormat::Auto) return config.format;
+    
+    const std::string& path = config.outputPath;
+    if (path.find('%') != std::string::npos) {
+        return endsWith(path, ".qoi") ? OutputFormat::QoiSequence : OutputFormat::PngSequence;
+    }
+    if (path == "-" || endsWith(path, ".y4m")) return OutputFormat::Y4M;
+    if (endsWith(path, ".yuv")) return OutputFormat::RawI420;
+    if (endsWith(path, ".bgr") || endsWith(path, ".raw")) return OutputFormat::RawBGR;
+    return OutputFormat::Container;
+}
+
+std::string outputExtension(OutputFormat format) {
+    switch (format) {
+        case OutputFormat::RawBGR: return ".bgr";
+        case OutputFormat::RawI420: return ".yuv";
+        case OutputFormat::Y4M: return ".y4m";
+        case OutputFormat::PngSequence: return ".png";
+        case OutputFormat::QoiSequence: return ".qoi";
+        default: return ".mp4";
+    }
+}
+
+std::unique_ptr<FrameSink> createFrameSink(const VideoConfig& config) {
+    OutputFormat format = resolveOutputFormat(config);
+    if (format == OutputFormat::Container) {
+        return std::make_unique<ContainerSink>();
+    }
+    if (isImageSequence(format)) {
+        return std::make_unique<ImageSequenceSink>(format);
+    }
+    return std::make_unique<RawStreamSink>(format);
+}
+
+bool concatenateContainers(const std::vector<ConcatEntry>& entries, const std::string& outputPath,
+                           std::string* errorMessage) {
+    const std::string listPath = outputPath + ".concat.txt";
+    {
+        std::ofstream list(listPath);
+        if (!list) {
+            if (errorMessage) *errorMessage = "Cannot write " + listPath;
+            return false;
+        }
+        list << "ffconcat version 1.0\n";
+        for (const auto& entry : entries) {
+            list << "file " << quote(fs::absolute(entry.path).string()) << "\n";
+            if (entry.seconds > 0.0) {
+                char duration[32];
+                std::snprintf(duration, sizeof(duration), "%.6f", entry.seconds);
+                list << "duration " << duration << "\n";
+            }
+        }
+    }
+    
+    const std::string command = "ffmpeg -hide_banner -loglevel error -y -f concat -safe 0 -i " +
+                                quote(listPath) + " -c copy " + quote(outputPath);
+    const int status = std::system(command.c_str());
+    std::error_code ec;
+    fs::remove(listPath, ec);
+    
+    if (status != 0) {
+        if (errorMessage) *errorMessage = "ffmpeg concat failed (status " + std::to_string(status) + ")";
+        return false;
+    }
+    return true;
+}
+
+} // namespace fourier
@@ -0,0 +1,207 @@
+#include "live_pipeline.hpp"
+#include "profiler.hpp"
+#include <opencv2/highgui.hpp>
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace fourier {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Nearest-rank percentile of sorted samples
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+const char* WINDOW_NAME = "Fourier Animation (live)";
+
+} // namespace
+
+class LivePipeline::Impl {
+public:
+    LiveConfig liveConfig;
+    ContourConfig contourConfig;
+    AnimationConfig animConfig;
+    VideoConfig videoConfig;
+    DFTOptions dftOptions;
+    
+    AnimationEngine engine;
+    bool engineReady = false;
+    
+    // Feed a frame to the tracker and refit the engine when the shape
+    // changed; returns false when it did not
+    bool updateShape(ShapeTracker& tracker, const cv::Mat& scaled) {
+        if (tracker.update(scaled) != TrackUpdate::Updated) return false;
+        const auto& coefficients = tracker.getCoefficients();
+        
+        // The tracker's center and scale put the path back on the input shape
+        cv::Point2d center = animConfig.center;
+        double scale = animConfig.scale;
+        if (liveConfig.overlay) {
+            center = tracker.getCenter();
+            scale = tracker.getScale();
+        }
+        
+        if (!engineReady) {
+            AnimationConfig config = animConfig;
+            config.center = center;
+            config.scale = scale;
+            engine.initialize(coefficients, config);
+            engineReady = true;
+        } else {
+            engine.setCoefficients(coefficients, center, scale);
+        }
+        return true;
+    }
+};
+
+LivePipeline::LivePipeline(const LiveConfig& liveConfig,
+                           const ContourConfig& contourConfig,
+                           const AnimationConfig& animConfig,
+                           const VideoConfig& videoConfig,
+                           const DFTOptions& dftOptions)
+    : pImpl(std::make_unique<Impl>()) {
+    pImpl->liveConfig = liveConfig;
+    pImpl->contourConfig = contourConfig;
+    pImpl->animConfig = animConfig;
+    pImpl->videoConfig = videoConfig;
+    pImpl->dftOptions = dftOptions;
+    
+    // The input is added into the pooled frames in place, so a reused
+    // buffer no longer holds a clean render: redraw every frame in full
+    if (liveConfig.overlay) {
+        pImpl->animConfig.dirtyRectangles = false;
+    }
+}
+
+LivePipeline::~LivePipeline() = default;
+
+bool LivePipeline::openSource(cv::VideoCapture& capture, const std::string& source) {
+    bool isCamera = !source.empty() &&
+        std::all_of(source.begin(), source.end(),
+                    [](unsigned char c) { return std::isdigit(c) != 0; });
+    if (isCamera) {
+        capture.open(std::stoi(source));
+    } else {
+        capture.open(source);
+    }
+    return capture.isOpened();
+}
+
+LiveStats LivePipeline::run() {
+    const auto& liveConfig = pImpl->liveConfig;
+    const auto& animConfig = pImpl->animConfig;
+    LiveStats stats;
+    
+    cv::VideoCapture capture;
+    if (!openSource(capture, liveConfig.source)) {
+        stats.errorMessage = "Failed to open video source: " + liveConfig.source;
+        return stats;
+    }
+    
+    // Record at the source's rate when it reports one
+    VideoConfig video = pImpl->videoConfig;
+    double sourceFps = capture.get(cv::CAP_PROP_FPS);
+    if (sourceFps > 0.0) {
+        video.fps = sourceFps;
+    }
+    std::cout << "[Live] Source: " << liveConfig.source << " ("
+              << capture.get(cv::CAP_PROP_FRAME_WIDTH) << "x"
+              << capture.get(cv::CAP_PROP_FRAME_HEIGHT) << " @ " << sourceFps << " fps), "
+              << "budget " << liveConfig.latencyBudgetMs << " ms/frame" << std::endl;
+    
+    VideoWriter writer;
+    if (liveConfig.record && !writer.open(video)) {
+        stats.errorMessage = "Failed to open video writer for " + video.outputPath;
+        return stats;
+    }
+    if (liveConfig.display) {
+        cv::namedWindow(WINDOW_NAME);
+    }
+    
+    // Reused across frames: capture target, input scaled to the output
+    // resolution and the tracker's extractor images and coefficients
+    ShapeTracker tracker(liveConfig.tracking, pImpl->contourConfig,
+                         animConfig.numCircles, pImpl->dftOptions);
+    cv::Mat input;
+    cv::Mat scaled;
+    std::vector<double> latencies;
+    bool keepShape = false;
+    bool stop = false;
+    
+    auto runStart = Clock::now();
+    while (!stop && (liveConfig.maxFrames <= 0 || stats.framesIn < liveConfig.maxFrames)) {
+        if (!capture.read(input) || input.empty()) break;
+        auto frameStart = Clock::now();
+        stats.framesIn++;
+        
+        {
+            FOURIER_PROFILE_SCOPE("live.resize");
+            cv::resize(input, scaled, animConfig.resolution);
+        }
+        
+        // Over budget last frame: render the previous shape only
+        if (!keepShape || !pImpl->engineReady) {
+            if (pImpl->updateShape(tracker, scaled)) {
+                stats.shapeUpdates++;
+            }
+        }
+        if (!pImpl->engineReady) continue;  // No contour seen yet
+        
+        cv::Mat frame = pImpl->engine.renderFrame(stats.framesOut % std::max(animConfig.totalFrames, 1));
+        if (frame.empty()) break;
+        if (liveConfig.overlay) {
+            FOURIER_PROFILE_SCOPE("live.overlay");
+            cv::addWeighted(frame, 1.0, scaled, liveConfig.overlayOpacity, 0.0, frame);
+        }
+        
+        if (liveConfig.record) {
+            writer.writeFrame(frame);
+        }
+        if (liveConfig.display) {
+            cv::imshow(WINDOW_NAME, frame);
+            int key = cv::waitKey(1);
+            stop = (key == 'q' || key == 27);
+        }
+        stats.framesOut++;
+        
+        double latency = elapsedMs(frameStart);
+        latencies.push_back(latency);
+        keepShape = latency > liveConfig.latencyBudgetMs;
+        if (keepShape) stats.overBudget++;
+    }
+    
+    if (liveConfig.record) {
+        writer.release();
+    }
+    if (liveConfig.display) {
+        cv::destroyWindow(WINDOW_NAME);
+    }
+    stats.wallSeconds = std::chrono::duration<double>(Clock::now() - runStart).count();
+    stats.tracking = tracker.getStats();
+    
+    std::sort(latencies.begin(), latencies.end());
+    stats.p50LatencyMs = percentile(latencies, 0.50);
+    stats.p95LatencyMs = percentile(latencies, 0.95);
+    stats.maxLatencyMs = latencies.empty() ? 0.0 : latencies.back();
+    stats.success = true;
+    if (stats.framesOut == 0) {
+        stats.errorMessage = "No contour found in any input frame";
+        stats.success = false;
+    }
+    return stats;
+}
+
+} // namespace fourier
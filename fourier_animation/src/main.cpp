@@ -1,18 +1,57 @@
 #include <iostream>
 #include <string>
 #include <chrono>
+#include <algorithm>
 #include <spdlog/spdlog.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <csignal>
+#include <cstdlib>
 #include <indicators/progress_bar.hpp>
 
 #include "fourier.hpp"
 #include "contour_extractor.hpp"
 #include "animation.hpp"
 #include "video_writer.hpp"
+#include "frame_sink.hpp"
+#include "parallel_renderer.hpp"
+#include "batch_processor.hpp"
+#include "live_pipeline.hpp"
+#include "profiler.hpp"
+#include "coefficient_cache.hpp"
+#include "chunked_renderer.hpp"
+
+// Everything set from the command line
+struct Options {
+    fourier::ContourConfig contourConfig;
+    fourier::AnimationConfig animConfig;
+    fourier::VideoConfig videoConfig;
+    fourier::DFTOptions dftOptions;
+    fourier::BatchConfig batchConfig;
+    fourier::LiveConfig liveConfig;
+    int renderThreads = 1;
+    int maxContours = 1;  // > 1: one epicycle chain per contour
+    fourier::FrameRange frameRange;  // Clamped to the animation by parseArgs
+    int chunks = 1;                  // > 1: chunks encoded in parallel, then merged
+    bool outputGiven = false;
+    std::string saveCoeffsPath;
+    bool coeffsHalf = false;
+    std::string cacheDir;                 // Empty: no coefficient cache
+    uint64_t cacheBytes = 256ull << 20;
+    std::string profilePath;
+    std::string tracePath;
+};
 
 void printUsage(const char* programName) {
-    spdlog::info("Usage: {} <image_path> [options]\n"
+    spdlog::info("Usage: {0} <image_path> [options]\n"
+                 "       {0} --batch <dir|list> [options]\n"
+                 "       {0} --live <video|camera index> [options]\n"
+                 "       {0} --coeffs <file> [options]\n"
+                 "       {0} --merge <output> <chunk>...\n"
                  "Options:\n"
-                 "  --output <path>     Output video path (default: fourier_output.mp4)\n"
+                 "  --output <path>     Output video path, - for stdout (default: fourier_output.mp4)\n"
+                 "  --format <name>     Output: auto, container, bgr, i420, y4m, png, qoi (default: auto, from the path)\n"
+                 "  --sequence-threads <n> Image sequence compression threads (default: 0 = one per core)\n"
+                 "  --crop-changes      Image sequences: store only the changed box of each frame, plus manifest.json\n"
                  "  --circles <num>     Number of epicycles (default: 100)\n"
                  "  --frames <num>      Total frames (default: 600)\n"
                  "  --fps <num>         Frames per second (default: 60)\n"
@@ -22,7 +61,44 @@ void printUsage(const char* programName) {
                  "  --no-vectors        Hide radius vectors\n"
                  "  --no-path           Hide traced path\n"
                  "  --samples <num>     Contour sample points (default: 500)\n"
+                 "  --select <metric>   Contour to animate: length, area (default: length)\n"
+                 "  --merge-holes       Join holes inside the contour into its outline\n"
+                 "  --contours <num>    Animate this many contours at once, sharing --circles (default: 1)\n"
+                 "  --fft-size <mode>   FFT length: exact, smooth, pow2 (default: exact)\n"
+                 "  --fft-float         Single-precision FFT\n"
+                 "  --save-coeffs <file> Write the full spectra as a coefficient file (replay with --coeffs)\n"
+                 "  --coeffs-f16        Store --save-coeffs values as float16\n"
+                 "  --cache-dir <dir>   Reuse coefficients of images seen before (keyed by content and settings)\n"
+                 "  --cache-size <MB>   Coefficient cache limit, least recently used evicted (default: 256)\n"
                  "  --cpu               Force CPU encoding\n"
+                 "  --threads <num>     Render threads (default: 1)\n"
+                 "  --kernel <name>     Epicycle evaluator: phasor, auto, scalar, avx2, neon, table (default: phasor)\n"
+                 "  --trig-error <px>   Largest position error of the table kernel (default: 0.1)\n"
+                 "  --backend <name>    Renderer: auto, opencv, cairo (default: auto)\n"
+                 "  --path-samples <n>  Traced path samples per frame (default: 8)\n"
+                 "  --lod <px>          Fold tail epicycles below this error into one vector (default: 0.5, 0 = off)\n"
+                 "  --full-redraw       Copy the whole background every frame (no dirty rects)\n"
+                 "  --async             Encode on a separate thread\n"
+                 "  --queue-depth <num> Frames queued for the async encoder (default: 8)\n"
+                 "  --intro-hold <s>    Show the first frame this long before drawing (default: 0)\n"
+                 "  --end-hold <s>      Show the finished drawing this long (default: 2)\n"
+                 "  --frame-range <a:b> Render only frames a to b-1, e.g. one shard of a long render\n"
+                 "  --chunks <num>      Encode the range as this many parallel chunks, then merge (default: 1)\n"
+                 "  --gop <frames>      Keyframe interval; chunk boundaries are aligned to it (default: fps)\n"
+                 "  --profile <path>    Write per-stage p50/p95/p99 timings as JSON\n"
+                 "  --trace <path>      Write a Chrome trace-event file\n"
+                 "Batch options:\n"
+                 "  --output-dir <dir>  Directory for batch videos (default: batch_output)\n"
+                 "  --jobs <num>        Images processed concurrently (default: 2)\n"
+                 "  --encoders <num>    Encode threads fed by the render workers (default: 1)\n"
+                 "Live options:\n"
+                 "  --latency-budget <ms> Per-frame target; slower frames keep the previous shape (default: 50)\n"
+                 "  --live-frames <num> Stop after this many input frames (default: 0 = all)\n"
+                 "  --display           Show frames in a window (records only with --output)\n"
+                 "  --no-overlay        Centered epicycles only, without the input underneath\n"
+                 "  --no-tracking       Search and transform every frame from scratch\n"
+                 "  --track-threshold <px> Sample motion below which the FFT is skipped (default: 1)\n"
+                 "  --smoothing <w>     Weight of the newest coefficients, 1 = none (default: 0.5)\n"
                  "  --help              Show this help message", programName);
 }
 
@@ -44,16 +120,33 @@ bool checkHelp(int argc, char* argv[]) {
     return false;
 }
 
-// Parse command line arguments
-void parseArgs(int argc, char* argv[],
-               fourier::ContourConfig& contourConfig,
-               fourier::AnimationConfig& animConfig,
-               fourier::VideoConfig& videoConfig) {
-    for (int i = 2; i < argc; ++i) {
+// Parse command line arguments (options start at argv[firstOption])
+void parseArgs(int argc, char* argv[], int firstOption, Options& options) {
+    auto& contourConfig = options.contourConfig;
+    auto& animConfig = options.animConfig;
+    auto& videoConfig = options.videoConfig;
+    auto& dftOptions = options.dftOptions;
+    auto& batchConfig = options.batchConfig;
+
+    for (int i = firstOption; i < argc; ++i) {
         std::string arg = argv[i];
 
         if (arg == "--output" && i + 1 < argc) {
             videoConfig.outputPath = argv[++i];
+            options.outputGiven = true;
+        } else if (arg == "--format" && i + 1 < argc) {
+            std::string name = argv[++i];
+            if (name == "container") videoConfig.format = fourier::OutputFormat::Container;
+            else if (name == "bgr") videoConfig.format = fourier::OutputFormat::RawBGR;
+            else if (name == "i420") videoConfig.format = fourier::OutputFormat::RawI420;
+            else if (name == "y4m") videoConfig.format = fourier::OutputFormat::Y4M;
+            else if (name == "png") videoConfig.format = fourier::OutputFormat::PngSequence;
+            else if (name == "qoi") videoConfig.format = fourier::OutputFormat::QoiSequence;
+            else videoConfig.format = fourier::OutputFormat::Auto;
+        } else if (arg == "--sequence-threads" && i + 1 < argc) {
+            videoConfig.sequenceThreads = std::max(0, std::stoi(argv[++i]));
+        } else if (arg == "--crop-changes") {
+            videoConfig.sequenceCropChanges = true;
         } else if (arg == "--circles" && i + 1 < argc) {
             animConfig.numCircles = std::stoi(argv[++i]);
         } else if (arg == "--frames" && i + 1 < argc) {
@@ -79,10 +172,295 @@ void parseArgs(int argc, char* argv[],
             animConfig.showPath = false;
         } else if (arg == "--samples" && i + 1 < argc) {
             contourConfig.numSamplePoints = std::stoi(argv[++i]);
+        } else if (arg == "--select" && i + 1 < argc) {
+            std::string metric = argv[++i];
+            contourConfig.selectBy = (metric == "area") ? fourier::ContourMetric::Area
+                                                        : fourier::ContourMetric::ArcLength;
+        } else if (arg == "--merge-holes") {
+            contourConfig.mergeNested = true;
+        } else if (arg == "--contours" && i + 1 < argc) {
+            options.maxContours = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--fft-size" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "smooth") dftOptions.sizePolicy = fourier::FFTSizePolicy::NextSmooth;
+            else if (mode == "pow2") dftOptions.sizePolicy = fourier::FFTSizePolicy::NextPowerOfTwo;
+            else dftOptions.sizePolicy = fourier::FFTSizePolicy::Exact;
+        } else if (arg == "--fft-float") {
+            dftOptions.singlePrecision = true;
+        } else if (arg == "--save-coeffs" && i + 1 < argc) {
+            options.saveCoeffsPath = argv[++i];
+        } else if (arg == "--coeffs-f16") {
+            options.coeffsHalf = true;
+        } else if (arg == "--cache-dir" && i + 1 < argc) {
+            options.cacheDir = argv[++i];
+        } else if (arg == "--cache-size" && i + 1 < argc) {
+            options.cacheBytes = static_cast<uint64_t>(std::max(0.0, std::stod(argv[++i])) * (1 << 20));
         } else if (arg == "--cpu") {
             videoConfig.useHardwareEncoding = false;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.renderThreads = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--kernel" && i + 1 < argc) {
+            std::string name = argv[++i];
+            animConfig.usePhasorEvaluator = (name == "phasor");
+            if (name == "scalar") animConfig.kernel = fourier::KernelType::Scalar;
+            else if (name == "avx2") animConfig.kernel = fourier::KernelType::AVX2;
+            else if (name == "neon") animConfig.kernel = fourier::KernelType::NEON;
+            else if (name == "table") animConfig.kernel = fourier::KernelType::Table;
+            else animConfig.kernel = fourier::KernelType::Auto;
+        } else if (arg == "--trig-error" && i + 1 < argc) {
+            animConfig.trigMaxPixelError = std::stod(argv[++i]);
+        } else if (arg == "--backend" && i + 1 < argc) {
+            std::string name = argv[++i];
+            if (name == "opencv") animConfig.backend = fourier::RenderBackend::OpenCV;
+            else if (name == "cairo") animConfig.backend = fourier::RenderBackend::Cairo;
+            else animConfig.backend = fourier::RenderBackend::Auto;
+        } else if (arg == "--path-samples" && i + 1 < argc) {
+            animConfig.pathSamplesPerFrame = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--lod" && i + 1 < argc) {
+            animConfig.lodPixelError = std::max(0.0, std::stod(argv[++i]));
+        } else if (arg == "--full-redraw") {
+            animConfig.dirtyRectangles = false;
+        } else if (arg == "--async") {
+            videoConfig.asyncEncoding = true;
+        } else if (arg == "--queue-depth" && i + 1 < argc) {
+            videoConfig.queueDepth = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--intro-hold" && i + 1 < argc) {
+            videoConfig.introHoldSeconds = std::max(0.0, std::stod(argv[++i]));
+        } else if (arg == "--end-hold" && i + 1 < argc) {
+            videoConfig.endHoldSeconds = std::max(0.0, std::stod(argv[++i]));
+        } else if (arg == "--frame-range" && i + 1 < argc) {
+            if (!fourier::parseFrameRange(argv[++i], options.frameRange)) {
+                spdlog::warn("Ignoring invalid frame range {}", argv[i]);
+                options.frameRange = fourier::FrameRange();
+            }
+        } else if (arg == "--chunks" && i + 1 < argc) {
+            options.chunks = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--gop" && i + 1 < argc) {
+            videoConfig.keyframeInterval = std::max(0, std::stoi(argv[++i]));
+        } else if (arg == "--output-dir" && i + 1 < argc) {
+            batchConfig.outputDir = argv[++i];
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            batchConfig.renderWorkers = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--encoders" && i + 1 < argc) {
+            batchConfig.maxEncoders = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--latency-budget" && i + 1 < argc) {
+            options.liveConfig.latencyBudgetMs = std::stod(argv[++i]);
+        } else if (arg == "--live-frames" && i + 1 < argc) {
+            options.liveConfig.maxFrames = std::max(0, std::stoi(argv[++i]));
+        } else if (arg == "--display") {
+            options.liveConfig.display = true;
+        } else if (arg == "--no-overlay") {
+            options.liveConfig.overlay = false;
+        } else if (arg == "--no-tracking") {
+            options.liveConfig.tracking.enabled = false;
+        } else if (arg == "--track-threshold" && i + 1 < argc) {
+            options.liveConfig.tracking.reuseThreshold = std::max(0.0, std::stod(argv[++i]));
+        } else if (arg == "--smoothing" && i + 1 < argc) {
+            options.liveConfig.tracking.smoothing = std::clamp(std::stod(argv[++i]), 0.0, 1.0);
+        } else if (arg == "--profile" && i + 1 < argc) {
+            options.profilePath = argv[++i];
+        } else if (arg == "--trace" && i + 1 < argc) {
+            options.tracePath = argv[++i];
+        }
+    }
+
+    // A live window replaces the video unless an output was asked for
+    options.liveConfig.record = !options.liveConfig.display || options.outputGiven;
+
+    // A shard's image files are numbered as in the full render
+    options.frameRange = fourier::clampFrameRange(options.frameRange, animConfig.totalFrames);
+    videoConfig.firstFileIndex = videoConfig.outputIndex(options.frameRange.start);
+
+    // Rendered frames stay pooled while queued for the encoder
+    if (videoConfig.asyncEncoding) {
+        animConfig.framePoolSize = std::max(animConfig.framePoolSize, videoConfig.queueDepth + 4);
+    }
+}
+
+// Frames streamed to stdout: every log line goes to stderr instead, and a
+// reader that exits makes writes fail rather than killing the process
+void prepareStdoutStream(const Options& options) {
+    if (options.videoConfig.outputPath != "-") return;
+
+    std::cout.rdbuf(std::cerr.rdbuf());
+    spdlog::set_default_logger(spdlog::stderr_color_mt("stderr"));
+    std::signal(SIGPIPE, SIG_IGN);
+}
+
+// OpenCV's FFmpeg writer reads encoder options only from the environment,
+// when a writer opens. Chunks of a sharded render must start on the --gop
+// cadence, so the keyframe interval is set there once, before any thread
+// starts; other renders keep the codec's own keyframe placement.
+void pinShardKeyframes(const Options& options) {
+    const bool sharded = options.chunks > 1 ||
+                         options.frameRange.size() != options.animConfig.totalFrames;
+    if (!sharded) return;
+
+    const char* existing = std::getenv("OPENCV_FFMPEG_WRITER_OPTIONS");
+    std::string value = "g;" + std::to_string(options.videoConfig.keyframeFrames()) + "|sc_threshold;0";
+    if (existing && *existing) value = std::string(existing) + "|" + value;
+    ::setenv("OPENCV_FFMPEG_WRITER_OPTIONS", value.c_str(), 1);
+}
+
+// Write the profiler outputs requested on the command line
+void writeProfile(const Options& options) {
+    if (options.profilePath.empty() && options.tracePath.empty()) return;
+#ifndef FOURIER_PROFILING
+    spdlog::warn("Built without -DFOURIER_PROFILING=ON: no stage timings were recorded");
+#endif
+
+    auto& profiler = fourier::Profiler::instance();
+    profiler.setEnabled(false);
+
+    for (const auto& stage : profiler.summarize()) {
+        spdlog::info("{:<28} n={:<6} p50={:.1f}us p95={:.1f}us p99={:.1f}us",
+                     stage.name, stage.count, stage.p50Us, stage.p95Us, stage.p99Us);
+    }
+    if (!options.profilePath.empty() && profiler.writeJson(options.profilePath)) {
+        spdlog::info("Profile: {}", options.profilePath);
+    }
+    if (!options.tracePath.empty() && profiler.writeChromeTrace(options.tracePath)) {
+        spdlog::info("Trace: {}", options.tracePath);
+    }
+}
+
+// Full spectra of the image's animated contours (one per epicycle chain),
+// from the coefficient cache when this image and these settings were seen
+// before
+bool computeSpectra(const std::string& imagePath, const Options& options,
+                    fourier::CoefficientChains& spectra) {
+    std::unique_ptr<fourier::CoefficientCache> cache;
+    uint64_t cacheKey = 0;
+    if (!options.cacheDir.empty()) {
+        cache = std::make_unique<fourier::CoefficientCache>(options.cacheDir, options.cacheBytes);
+        cacheKey = fourier::CoefficientCache::key(imagePath, options.contourConfig,
+                                                  options.dftOptions, options.maxContours);
+        if (cache->load(cacheKey, spectra)) {
+            spdlog::info("Coefficients from cache: {}", cache->entryPath(cacheKey));
+            return true;
         }
     }
+
+    if (options.maxContours > 1) {
+        spdlog::warn("Extracting up to {} contours from image...", options.maxContours);
+        auto contours = fourier::extractContours(imagePath, options.maxContours, options.contourConfig);
+
+        if (!contours.success) {
+            spdlog::error("Error: {}", contours.errorMessage);
+            return false;
+        }
+
+        spdlog::info("Found {} contours", contours.shapes.size());
+        for (size_t i = 0; i < contours.shapes.size(); ++i) {
+            spdlog::info("Contour {}: {} points", i, contours.shapes[i].size());
+        }
+
+        spdlog::debug("Computing Fourier coefficients...");
+        spectra = fourier::computeDFTs(contours.shapes, 0, options.dftOptions);
+    } else {
+        // Extract contour from image
+        spdlog::warn("Extracting contour from image...");
+        auto contourResult = fourier::extractContour(imagePath, options.contourConfig);
+
+        if (!contourResult.success) {
+            spdlog::error("Error: {}", contourResult.errorMessage);
+            return false;
+        }
+
+        spdlog::info("Found contour with {} points", contourResult.complexPoints.size());
+
+        // Compute Fourier coefficients (DFT)
+        spdlog::debug("Computing Fourier coefficients...");
+        spectra = {fourier::computeDFT(contourResult.complexPoints, 0, options.dftOptions)};
+    }
+
+    if (cache) {
+        cache->store(cacheKey, spectra);
+        auto cacheStats = cache->getStats();
+        spdlog::debug("Coefficient cache: stored {}, evicted {}", cache->entryPath(cacheKey),
+                      cacheStats.evictions);
+    }
+    return true;
+}
+
+// Join chunks rendered with --frame-range (in frame order) without re-encoding
+int runMerge(const std::string& outputPath, const std::vector<std::string>& chunks) {
+    fourier::VideoConfig config;
+    config.outputPath = outputPath;
+    auto format = fourier::resolveOutputFormat(config);
+
+    spdlog::info("Merging {} chunks into {}", chunks.size(), outputPath);
+    std::string error;
+    if (!fourier::concatenateChunks(chunks, outputPath, format, &error)) {
+        spdlog::error("Error: {}", error);
+        return 1;
+    }
+    return 0;
+}
+
+// Process every image of a directory or list file
+int runBatch(const std::string& input, const Options& options) {
+    auto images = fourier::BatchProcessor::collectInputs(input);
+    if (images.empty()) {
+        spdlog::error("No images found in {}", input);
+        return 1;
+    }
+
+    spdlog::info("-- Fourier Animation Batch --");
+    spdlog::info("Input: {} ({} images)", input, images.size());
+    spdlog::info("Output dir: {}", options.batchConfig.outputDir);
+
+    fourier::BatchProcessor processor(options.batchConfig, options.contourConfig,
+                                      options.animConfig, options.videoConfig,
+                                      options.dftOptions);
+    std::unique_ptr<fourier::CoefficientCache> cache;
+    if (!options.cacheDir.empty()) {
+        cache = std::make_unique<fourier::CoefficientCache>(options.cacheDir, options.cacheBytes);
+        processor.setCoefficientCache(cache.get());
+    }
+    auto results = processor.run(images);
+    if (cache) {
+        auto cacheStats = cache->getStats();
+        spdlog::info("Coefficient cache: {} hits, {} misses, {} evicted",
+                     cacheStats.hits, cacheStats.misses, cacheStats.evictions);
+    }
+
+    auto failed = std::count_if(results.begin(), results.end(),
+                                [](const fourier::JobResult& r) { return !r.success; });
+    spdlog::info("=== Batch complete: {} succeeded, {} failed ===",
+                 results.size() - failed, failed);
+    return failed == 0 ? 0 : 1;
+}
+
+// Epicycles of every frame of a video file or camera
+int runLive(const std::string& source, Options options) {
+    options.liveConfig.source = source;
+
+    spdlog::info("-- Fourier Animation Live --");
+    spdlog::info("Source: {}", source);
+    spdlog::info("Output: {}", options.liveConfig.record ? options.videoConfig.outputPath : "window");
+    spdlog::info("Resolution: {}x{}", options.videoConfig.width, options.videoConfig.height);
+    spdlog::info("Epicycles: {}", options.animConfig.numCircles);
+
+    fourier::LivePipeline pipeline(options.liveConfig, options.contourConfig,
+                                   options.animConfig, options.videoConfig,
+                                   options.dftOptions);
+    auto stats = pipeline.run();
+    if (!stats.success) {
+        spdlog::error("Error: {}", stats.errorMessage);
+        return 1;
+    }
+
+    spdlog::info("=== Live complete: {} of {} frames, {:.1f} fps ===",
+                 stats.framesOut, stats.framesIn, stats.framesPerSecond());
+    spdlog::info("Latency: p50 {:.1f} ms, p95 {:.1f} ms, max {:.1f} ms ({} over the {:.0f} ms budget)",
+                 stats.p50LatencyMs, stats.p95LatencyMs, stats.maxLatencyMs,
+                 stats.overBudget, options.liveConfig.latencyBudgetMs);
+    spdlog::info("Shape updates: {} of {} frames", stats.shapeUpdates, stats.framesOut);
+    spdlog::info("Tracking: {} ROI / {} full searches, {} transforms, {} reused, {} lost",
+                 stats.tracking.roiSearches, stats.tracking.fullSearches,
+                 stats.tracking.transforms, stats.tracking.reused, stats.tracking.lost);
+    return 0;
 }
 
 int main(int argc, char* argv[]) {
@@ -95,43 +473,139 @@ int main(int argc, char* argv[]) {
 
     if (checkHelp(argc, argv)) return 0;
 
-    fourier::ContourConfig contourConfig;
-    fourier::AnimationConfig animConfig;
-    fourier::VideoConfig videoConfig;
+    Options options;
+
+    // Batch mode: --batch <dir|list> [options]
+    if (imagePath == "--batch") {
+        if (argc < 3) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        parseArgs(argc, argv, 3, options);
+        if (options.maxContours > 1 || !options.saveCoeffsPath.empty() ||
+            options.frameRange.size() != options.animConfig.totalFrames || options.chunks > 1) {
+            spdlog::error("--contours, --save-coeffs, --frame-range and --chunks "
+                          "are not supported with --batch");
+            return 1;
+        }
+        fourier::Profiler::instance().setEnabled(
+            !options.profilePath.empty() || !options.tracePath.empty());
+        int status = runBatch(argv[2], options);
+        writeProfile(options);
+        return status;
+    }
+
+    // Live mode: --live <video|camera index> [options]
+    if (imagePath == "--live") {
+        if (argc < 3) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        parseArgs(argc, argv, 3, options);
+        prepareStdoutStream(options);
+        fourier::Profiler::instance().setEnabled(
+            !options.profilePath.empty() || !options.tracePath.empty());
+        int status = runLive(argv[2], options);
+        writeProfile(options);
+        return status;
+    }
+
+    // Merge mode: --merge <output> <chunk>...
+    if (imagePath == "--merge") {
+        if (argc < 4) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        options.videoConfig.outputPath = argv[2];
+        prepareStdoutStream(options);
+        return runMerge(argv[2], std::vector<std::string>(argv + 3, argv + argc));
+    }
+
+    // Coefficient file mode: --coeffs <file> [options] (no extraction)
+    const bool fromCoefficientFile = (imagePath == "--coeffs");
+    if (fromCoefficientFile) {
+        if (argc < 3) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        imagePath = argv[2];
+    }
 
     // Parse command line arguments
-    parseArgs(argc, argv, contourConfig, animConfig, videoConfig);
+    parseArgs(argc, argv, fromCoefficientFile ? 3 : 2, options);
+    prepareStdoutStream(options);
+    pinShardKeyframes(options);
+    const auto& animConfig = options.animConfig;
+    const auto& videoConfig = options.videoConfig;
+    const int renderThreads = options.renderThreads;
+    const auto& range = options.frameRange;
+    fourier::Profiler::instance().setEnabled(
+        !options.profilePath.empty() || !options.tracePath.empty());
        
     spdlog::info("-- Fourier Animation Generator --");
-    spdlog::info("Image: {}", imagePath);
+    spdlog::info("{}: {}", fromCoefficientFile ? "Coefficients" : "Image", imagePath);
     spdlog::info("Output: {}", videoConfig.outputPath);
     spdlog::info("Resolution: {}x{}", videoConfig.width, videoConfig.height);
     spdlog::info("Epicycles: {}", animConfig.numCircles);
     spdlog::info("Frames: {} @ {} fps", animConfig.totalFrames, animConfig.fps);
+    if (range.size() != animConfig.totalFrames) {
+        spdlog::info("Frame range: {}-{}", range.start, range.end - 1);
+    }
+    spdlog::info("Render threads: {}", renderThreads);
 
     auto startTime = std::chrono::high_resolution_clock::now();
 
-    // Extract contour from image
-    spdlog::warn("Extracting contour from image...");
-    auto contourResult = fourier::extractContour(imagePath, contourConfig);
-
-    if (!contourResult.success) {
-        spdlog::error("Error: {}", contourResult.errorMessage);
+    // Fourier coefficients of each animated contour (one epicycle chain each)
+    fourier::CoefficientChains chains;
+    if (fromCoefficientFile) {
+        std::string error;
+        if (!fourier::loadCoefficients(imagePath, chains, &error)) {
+            spdlog::error("Error: {}", error);
+            return 1;
+        }
+        spdlog::info("Loaded {} epicycle chains", chains.size());
+    } else if (!computeSpectra(imagePath, options, chains)) {
         return 1;
     }
 
-    spdlog::info("Found contour with {} points", contourResult.complexPoints.size());
+    // Saved untruncated, so the file replays with any --circles
+    if (!options.saveCoeffsPath.empty()) {
+        if (fourier::saveCoefficients(options.saveCoeffsPath, chains, options.coeffsHalf)) {
+            spdlog::info("Coefficients: {}", options.saveCoeffsPath);
+        } else {
+            spdlog::error("Failed to write {}", options.saveCoeffsPath);
+        }
+    }
 
-    // Compute Fourier coefficients (DFT)
-    spdlog::debug("Computing Fourier coefficients...");
-    auto coefficients = fourier::computeDFT(contourResult.complexPoints, animConfig.numCircles);
+    // The circle budget is split across contours by energy
+    fourier::truncateSpectra(chains, animConfig.numCircles);
+    for (size_t i = 0; i < chains.size(); ++i) {
+        spdlog::info("Contour {}: {} Fourier coefficients", i, chains[i].size());
+    }
 
-    spdlog::info("Computed {} Fourier coefficients", coefficients.size());
+    // Fewer circles than contours leaves some without a term
+    std::erase_if(chains, [](const auto& chain) { return chain.empty(); });
+    auto planStats = fourier::FFTPlanCache::instance().getStats();
+    spdlog::debug("FFT plan cache: {} hits, {} misses", planStats.hits, planStats.misses);
+
+    // Parallel chunks, each with its own engine and encoder
+    if (options.chunks > 1) {
+        fourier::ChunkedRenderer chunked(options.chunks);
+        chunked.initialize(chains, animConfig, videoConfig);
+        auto chunkStats = chunked.render(range);
+        if (!chunkStats.success) {
+            spdlog::error("Error: {}", chunkStats.errorMessage);
+            return 1;
+        }
 
-    // Initialize animation
-    spdlog::debug("Initializing animation engine...");
-    fourier::AnimationEngine animator;
-    animator.initialize(coefficients, animConfig);
+        spdlog::info("=== Complete ===");
+        spdlog::info("Output: {}", videoConfig.outputPath);
+        spdlog::info("Rendered {} frames in {} chunks in {:.2f} s, merged in {:.2f} s",
+                     chunkStats.frames, chunkStats.chunks,
+                     chunkStats.wallSeconds, chunkStats.mergeSeconds);
+        writeProfile(options);
+        return 0;
+    }
 
     // Initialize video writer
     spdlog::debug("Writing video frames...");
@@ -154,31 +628,66 @@ int main(int argc, char* argv[]) {
         indicators::option::PostfixText{"Rendering frames"}
     };
 
-    // Render and write frames
-    for (int frame = 0; frame < animConfig.totalFrames; ++frame) {
-        cv::Mat frameImage = animator.renderFrame(frame);
-
+    // Write one rendered frame and update progress; the first and last
+    // frames are kept for the intro and end holds
+    cv::Mat lastFrame;
+    bool outputClosed = false;
+    auto writeRenderedFrame = [&](int frame, const cv::Mat& frameImage) {
         if (frameImage.empty()) {
             spdlog::error("Failed to render frame {}", frame);
-            continue;
+            return;
         }
+        if (outputClosed) return;
 
-        videoWriter.writeFrame(frameImage);
+        if (frame == 0) {
+            videoWriter.writeHold(frameImage, videoConfig.holdFrames(videoConfig.introHoldSeconds));
+        }
+        if (!videoWriter.writeFrame(frameImage)) {
+            spdlog::error("Output failed at frame {}, not writing more frames", frame);
+            outputClosed = true;
+            return;
+        }
+        if (frame == animConfig.totalFrames - 1) {
+            lastFrame = frameImage;
+        }
 
         // Update progress bar
-        int progress = static_cast<int>(100.0 * (frame + 1) / animConfig.totalFrames);
+        int progress = static_cast<int>(100.0 * (frame + 1 - range.start) / range.size());
         bar.set_progress(progress);
-    }
-
-    // Add 2-second pause at the end
-    if (animConfig.totalFrames > 0) {
-        int pauseFrames = static_cast<int>(videoConfig.fps * 2);
-        spdlog::debug("Adding 2-second pause ({} frames)...", pauseFrames);
-        cv::Mat lastFrame = animator.renderFrame(animConfig.totalFrames - 1);
+    };
 
-        for (int i = 0; i < pauseFrames; ++i) {
-            videoWriter.writeFrame(lastFrame);
+    // Render and write frames
+    if (renderThreads > 1) {
+        fourier::ParallelRenderer renderer(renderThreads);
+        renderer.initialize(chains, animConfig);
+        auto renderStats = renderer.render(writeRenderedFrame, range.start, range.end);
+
+        spdlog::info("Rendered {} frames on {} threads in {:.2f} s (worker utilization {:.0f}%)",
+                     renderStats.frames, renderStats.threads,
+                     renderStats.wallSeconds, 100.0 * renderStats.utilization());
+    } else {
+        // Single-threaded: one engine renders every frame here
+        spdlog::debug("Initializing animation engine...");
+        fourier::AnimationEngine animator;
+        animator.initialize(chains, animConfig);
+
+        // A range starting past frame 0 renders its first frame directly
+        for (int frame = range.start; frame < range.end; ++frame) {
+            writeRenderedFrame(frame, animator.renderFrame(frame));
         }
+
+        auto poolStats = animator.getFramePoolStats();
+        spdlog::debug("Frame pool: {}/{} buffers, {} of {} frames overflowed",
+                      poolStats.allocated, poolStats.capacity,
+                      poolStats.overflows, poolStats.acquired);
+    }
+
+    // Pause on the finished drawing (the frame already rendered, not rendered again)
+    if (!lastFrame.empty()) {
+        int pauseFrames = videoConfig.holdFrames(videoConfig.endHoldSeconds);
+        spdlog::debug("Adding {:.1f}-second pause ({} frames)...", videoConfig.endHoldSeconds, pauseFrames);
+        videoWriter.writeHold(lastFrame, pauseFrames);
+        lastFrame.release();
     }
 
     videoWriter.release();
@@ -189,7 +698,8 @@ int main(int argc, char* argv[]) {
     spdlog::info("=== Complete ===");
     spdlog::info("Output: {}", videoConfig.outputPath);
     spdlog::info("Total time: {:.2f} seconds", duration.count() / 1000.0);
-    spdlog::info("Average: {} ms/frame", duration.count() / animConfig.totalFrames);
+    spdlog::info("Average: {} ms/frame", duration.count() / std::max(range.size(), 1));
+    writeProfile(options);
 
     return 0;
 }
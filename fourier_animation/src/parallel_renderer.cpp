@@ -0,0 +1,144 @@
+#include "parallel_renderer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace fourier {
+
+ParallelRenderer::ParallelRenderer(int numThreads)
+    : numThreads(std::max(numThreads, 1)) {}
+
+ParallelRenderer::~ParallelRenderer() = default;
+
+void ParallelRenderer::initialize(const std::vector<FourierCoefficient>& coefficients,
+                                  const AnimationConfig& config) {
+    initialize(std::vector<std::vector<FourierCoefficient>>{coefficients}, config);
+}
+
+void ParallelRenderer::initialize(const std::vector<std::vector<FourierCoefficient>>& chains,
+                                  const AnimationConfig& config) {
+    this->config = config;
+    engines.clear();
+    
+    for (int i = 0; i < numThreads; ++i) {
+        auto engine = std::make_unique<AnimationEngine>();
+        engine->initialize(chains, config);
+        engines.push_back(std::move(engine));
+    }
+    
+    std::cout << "[ParallelRenderer] " << numThreads << " render threads" << std::endl;
+}
+
+ParallelRenderStats ParallelRenderer::render(const FrameCallback& onFrame, int firstFrame, int endFrame) {
+    using Clock = std::chrono::steady_clock;
+    
+    if (endFrame < 0 || endFrame > config.totalFrames) endFrame = config.totalFrames;
+    firstFrame = std::max(firstFrame, 0);
+    
+    ParallelRenderStats stats;
+    stats.threads = numThreads;
+    stats.frames = std::max(endFrame - firstFrame, 0);
+    
+    if (engines.empty() || stats.frames == 0) return stats;
+    
+    // Reorder buffer: finished frames waiting for their turn. Workers stall
+    // when they get too far ahead of the consumer to bound memory use.
+    const int maxAhead = 2 * numThreads;
+    std::map<int, cv::Mat> ready;
+    int nextFrame = firstFrame;
+    bool stopping = false;  // The consumer failed: workers exit
+    std::mutex mutex;
+    std::condition_variable frameReady;
+    std::condition_variable frameConsumed;
+    
+    std::vector<double> busySeconds(numThreads, 0.0);
+    auto start = Clock::now();
+    
+    // Worker w renders frames first + w, first + w + N, ... so each engine
+    // moves forward through the animation and extends its path layer
+    // incrementally
+    auto worker = [&](int w) {
+        AnimationEngine& engine = *engines[w];
+        
+        for (int frame = firstFrame + w; frame < endFrame; frame += numThreads) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                frameConsumed.wait(lock, [&] { return stopping || frame < nextFrame + maxAhead; });
+                if (stopping) return;
+            }
+            
+            auto renderStart = Clock::now();
+            cv::Mat image;
+            try {
+                image = engine.renderFrame(frame);
+            } catch (const std::exception& e) {
+                std::cerr << "[ParallelRenderer] Frame " << frame << " failed: " << e.what() << std::endl;
+            }
+            busySeconds[w] += std::chrono::duration<double>(Clock::now() - renderStart).count();
+            
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ready.emplace(frame, std::move(image));
+            }
+            frameReady.notify_one();
+        }
+    };
+    
+    std::vector<std::thread> workers;
+    workers.reserve(numThreads);
+    for (int w = 0; w < numThreads; ++w) {
+        workers.emplace_back(worker, w);
+    }
+    
+    auto joinWorkers = [&] {
+        for (auto& thread : workers) {
+            thread.join();
+        }
+    };
+    
+    // Hand frames to the consumer in sequence. If onFrame throws, the
+    // workers are stopped and joined before the exception propagates.
+    try {
+        for (int frame = firstFrame; frame < endFrame; ++frame) {
+            cv::Mat image;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                frameReady.wait(lock, [&] { return ready.count(frame) > 0; });
+                auto it = ready.find(frame);
+                image = std::move(it->second);
+                ready.erase(it);
+                nextFrame = frame + 1;
+            }
+            frameConsumed.notify_all();
+            
+            onFrame(frame, image);
+        }
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        frameConsumed.notify_all();
+        joinWorkers();
+        throw;
+    }
+    
+    joinWorkers();
+    
+    stats.wallSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    for (double seconds : busySeconds) {
+        stats.renderSeconds += seconds;
+    }
+    
+    return stats;
+}
+
+int ParallelRenderer::getThreadCount() const {
+    return numThreads;
+}
+
+} // namespace fourier
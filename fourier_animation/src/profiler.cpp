@@ -0,0 +1,155 @@
+#include "profiler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace fourier {
+
+namespace {
+
+double percentileUs(const std::vector<int64_t>& sortedNs, double p) {
+    if (sortedNs.empty()) return 0.0;
+    size_t rank = static_cast<size_t>(p * (sortedNs.size() - 1) + 0.5);
+    return sortedNs[std::min(rank, sortedNs.size() - 1)] / 1000.0;
+}
+
+} // namespace
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+int64_t Profiler::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Profiler::setEnabled(bool enabled) {
+    this->enabled.store(enabled, std::memory_order_relaxed);
+}
+
+uint32_t Profiler::registerStage(const char* name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = std::find(stageNames.begin(), stageNames.end(), name);
+    if (it != stageNames.end()) {
+        return static_cast<uint32_t>(it - stageNames.begin());
+    }
+    stageNames.emplace_back(name);
+    return static_cast<uint32_t>(stageNames.size() - 1);
+}
+
+Profiler::ThreadBuffer& Profiler::localBuffer() {
+    // The profiler keeps a reference so events outlive their thread
+    thread_local std::shared_ptr<ThreadBuffer> buffer = [this] {
+        auto created = std::make_shared<ThreadBuffer>();
+        created->events.reserve(4096);
+        std::lock_guard<std::mutex> lock(mutex);
+        created->threadId = static_cast<uint32_t>(buffers.size() + 1);
+        buffers.push_back(created);
+        return created;
+    }();
+    return *buffer;
+}
+
+void Profiler::record(uint32_t stage, int64_t startNs, int64_t durationNs) {
+    localBuffer().events.push_back({stage, startNs, durationNs});
+}
+
+std::vector<StageSummary> Profiler::summarize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    std::vector<std::vector<int64_t>> durations(stageNames.size());
+    for (const auto& buffer : buffers) {
+        for (const auto& event : buffer->events) {
+            durations[event.stage].push_back(event.durationNs);
+        }
+    }
+    
+    std::vector<StageSummary> summaries;
+    for (size_t i = 0; i < stageNames.size(); ++i) {
+        auto& values = durations[i];
+        if (values.empty()) continue;
+        std::sort(values.begin(), values.end());
+        
+        StageSummary summary;
+        summary.name = stageNames[i];
+        summary.count = values.size();
+        for (int64_t ns : values) summary.totalMs += ns / 1e6;
+        summary.p50Us = percentileUs(values, 0.50);
+        summary.p95Us = percentileUs(values, 0.95);
+        summary.p99Us = percentileUs(values, 0.99);
+        summary.maxUs = values.back() / 1000.0;
+        summaries.push_back(summary);
+    }
+    return summaries;
+}
+
+bool Profiler::writeJson(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "[Profiler] Failed to write " << path << std::endl;
+        return false;
+    }
+    
+    auto summaries = summarize();
+    out << std::fixed << std::setprecision(3);
+    out << "{\n  \"stages\": [\n";
+    for (size_t i = 0; i < summaries.size(); ++i) {
+        const auto& s = summaries[i];
+        out << "    {\"name\": \"" << s.name << "\""
+            << ", \"count\": " << s.count
+            << ", \"total_ms\": " << s.totalMs
+            << ", \"p50_us\": " << s.p50Us
+            << ", \"p95_us\": " << s.p95Us
+            << ", \"p99_us\": " << s.p99Us
+            << ", \"max_us\": " << s.maxUs << "}"
+            << (i + 1 < summaries.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "[Profiler] Failed to write " << path << std::endl;
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    int64_t originNs = INT64_MAX;
+    for (const auto& buffer : buffers) {
+        for (const auto& event : buffer->events) {
+            originNs = std::min(originNs, event.startNs);
+        }
+    }
+    
+    out << std::fixed << std::setprecision(3);
+    out << "{\"traceEvents\": [\n";
+    bool first = true;
+    for (const auto& buffer : buffers) {
+        for (const auto& event : buffer->events) {
+            out << (first ? "" : ",\n")
+                << "{\"name\": \"" << stageNames[event.stage] << "\", \"ph\": \"X\""
+                << ", \"ts\": " << (event.startNs - originNs) / 1000.0
+                << ", \"dur\": " << event.durationNs / 1000.0
+                << ", \"pid\": 1, \"tid\": " << buffer->threadId << "}";
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+void Profiler::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& buffer : buffers) {
+        buffer->events.clear();
+    }
+}
+
+} // namespace fourier
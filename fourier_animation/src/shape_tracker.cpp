@@ -0,0 +1,132 @@
+#include "shape_tracker.hpp"
+#include "profiler.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace fourier {
+
+namespace {
+
+// Bounding box grown by `margin` of its size on every side
+cv::Rect padRect(const cv::Rect& rect, double margin) {
+    int dx = static_cast<int>(std::ceil(rect.width * margin)) + 2;
+    int dy = static_cast<int>(std::ceil(rect.height * margin)) + 2;
+    return cv::Rect(rect.x - dx, rect.y - dy, rect.width + 2 * dx, rect.height + 2 * dy);
+}
+
+// True if box touches a side of roi that is not also an image border,
+// i.e. the shape may continue outside the searched region
+bool reachesCut(const cv::Rect& box, const cv::Rect& roi, const cv::Size& image) {
+    return (roi.x > 0 && box.x <= roi.x) ||
+           (roi.y > 0 && box.y <= roi.y) ||
+           (roi.br().x < image.width && box.br().x >= roi.br().x) ||
+           (roi.br().y < image.height && box.br().y >= roi.br().y);
+}
+
+// Root-mean-square distance between corresponding points
+double rmsDistance(const std::vector<cv::Point2d>& a, const std::vector<cv::Point2d>& b) {
+    double sum = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        double dx = a[i].x - b[i].x;
+        double dy = a[i].y - b[i].y;
+        sum += dx * dx + dy * dy;
+    }
+    return a.empty() ? 0.0 : std::sqrt(sum / a.size());
+}
+
+} // namespace
+
+ShapeTracker::ShapeTracker(const TrackerConfig& config,
+                           const ContourConfig& contourConfig,
+                           int numCircles,
+                           const DFTOptions& dftOptions)
+    : config(config), numCircles(numCircles), dftOptions(dftOptions), extractor(contourConfig) {}
+
+void ShapeTracker::reset() {
+    tracking = false;
+    bounds = cv::Rect();
+    framesSinceFullSearch = 0;
+    reference.clear();
+    coefficients.clear();
+}
+
+TrackUpdate ShapeTracker::update(const cv::Mat& frame) {
+    FOURIER_PROFILE_SCOPE("ShapeTracker.update");
+    stats.frames++;
+    
+    // Warm start: search around the last contour first
+    ContourResult contour;
+    bool found = false;
+    if (config.enabled && tracking && framesSinceFullSearch < config.fullSearchInterval) {
+        cv::Rect roi = padRect(bounds, config.roiMargin) & cv::Rect(0, 0, frame.cols, frame.rows);
+        contour = extractor.extract(frame, roi);
+        found = contour.success &&
+                !reachesCut(cv::boundingRect(contour.originalContour), roi, frame.size());
+        if (found) {
+            stats.roiSearches++;
+            framesSinceFullSearch++;
+        }
+    }
+    if (!found) {
+        contour = extractor.extract(frame);
+        found = contour.success;
+        stats.fullSearches++;
+        framesSinceFullSearch = 0;
+    }
+    if (!found) {
+        stats.lost++;
+        framesSinceFullSearch = config.fullSearchInterval;
+        return TrackUpdate::None;
+    }
+    bounds = cv::boundingRect(contour.originalContour);
+    
+    // Sampled points back in pixels: complexPoints are (p - centroid) * scale
+    const double pixelScale = 1.0 / contour.scale;
+    samples.resize(contour.complexPoints.size());
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const auto& z = contour.complexPoints[i];
+        samples[i] = cv::Point2d(contour.centroid.x + z.real() * pixelScale,
+                                 contour.centroid.y + z.imag() * pixelScale);
+    }
+    
+    // Compared with the points the coefficients came from, so slow drift
+    // still triggers a transform once it adds up
+    if (config.enabled && tracking && samples.size() == reference.size() &&
+        rmsDistance(samples, reference) < config.reuseThreshold) {
+        stats.reused++;
+        return TrackUpdate::Reused;
+    }
+    
+    auto latest = computeDFT(contour.complexPoints, numCircles, dftOptions);
+    stats.transforms++;
+    reference.swap(samples);
+    
+    const double alpha = (config.enabled && tracking) ? std::clamp(config.smoothing, 0.0, 1.0) : 1.0;
+    if (alpha < 1.0) {
+        // Express the history in this frame's units before blending
+        const double ratio = scale / pixelScale;
+        for (auto& coef : coefficients) {
+            coef.cn *= ratio;
+            coef.amplitude *= ratio;
+        }
+        center += (contour.centroid - center) * alpha;
+        scale += alpha * (pixelScale - scale);
+        
+        // Blend in this frame's units, then express in the smoothed scale
+        smoothCoefficients(coefficients, latest, alpha);
+        const double toSmoothed = pixelScale / scale;
+        for (auto& coef : coefficients) {
+            coef.cn *= toSmoothed;
+            coef.amplitude *= toSmoothed;
+        }
+    } else {
+        coefficients = std::move(latest);
+        center = contour.centroid;
+        scale = pixelScale;
+    }
+    
+    tracking = true;
+    return TrackUpdate::Updated;
+}
+
+} // namespace fourier
@@ -1,16 +1,105 @@
 #include "video_writer.hpp"
+#include "frame_sink.hpp"
+#include "frame_queue.hpp"
+#include "frame_pool.hpp"
+#include "profiler.hpp"
 #include <opencv2/videoio.hpp>
 #include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <thread>
 
 namespace fourier {
 
+namespace {
+
+// Encoder queue entry: a frame and how many frame periods it is shown for
+struct QueuedFrame {
+    cv::Mat frame;
+    int repeats = 1;
+};
+
+} // namespace
+
 class VideoWriter::Impl {
 public:
-    cv::VideoWriter writer;
+    std::unique_ptr<FrameSink> sink;
     VideoConfig config;
     int frameCount = 0;
     bool opened = false;
+    std::atomic<bool> failed{false};  // Sink write error (set on the encode thread)
+    
+    // Async mode: frames travel from the render thread to encodeThread
+    std::unique_ptr<SpscRing<QueuedFrame>> queue;
+    std::thread encodeThread;
+    VideoWriterStats stats;
+    
+    // Resize target; each resized frame is encoded before the next one
+    FramePool resizePool{1};
+    
+    void encode(const cv::Mat& frame, int repeats = 1) {
+        auto start = std::chrono::steady_clock::now();
+        
+        cv::Mat resizedFrame;
+        if (frame.cols != config.width || frame.rows != config.height) {
+            FOURIER_PROFILE_SCOPE("writeFrame.resize");
+            resizedFrame = resizePool.acquire();
+            cv::resize(frame, resizedFrame, cv::Size(config.width, config.height));
+        } else {
+            resizedFrame = frame;
+        }
+        
+        {
+            FOURIER_PROFILE_SCOPE("writeFrame.encode");
+            if (!sink->write(resizedFrame, repeats)) {
+                failed = true;
+            }
+        }
+        
+        stats.framesEncoded += repeats;
+        if (repeats > 1) stats.heldFrames += repeats;
+        stats.encodeSeconds += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+    
+    void startEncodeThread() {
+        queue = std::make_unique<SpscRing<QueuedFrame>>(std::max(config.queueDepth, 1));
+        encodeThread = std::thread([this] {
+            QueuedFrame item;
+            while (queue->waitForItem()) {
+                while (queue->tryPop(item)) {
+                    encode(item.frame, item.repeats);
+                    item.frame.release();
+                }
+            }
+        });
+    }
+    
+    void stopEncodeThread() {
+        if (!queue) return;
+        queue->close();
+        if (encodeThread.joinable()) encodeThread.join();
+        queue.reset();
+    }
+    
+    bool enqueue(QueuedFrame&& item) {
+        int queued = static_cast<int>(queue->size()) + 1;
+        
+        if (!queue->tryPush(std::move(item))) {
+            // Back-pressure: the encoder is behind, wait for a free slot
+            auto start = std::chrono::steady_clock::now();
+            queue->waitForSpace();
+            stats.stallSeconds += std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start).count();
+            queued = static_cast<int>(queue->size()) + 1;
+            queue->tryPush(std::move(item));
+        }
+        
+        stats.queueHighWater = std::max(stats.queueHighWater, queued);
+        return true;
+    }
 };
 
 VideoWriter::VideoWriter() : pImpl(std::make_unique<Impl>()) {}
@@ -22,72 +111,67 @@ VideoWriter::~VideoWriter() {
 bool VideoWriter::open(const VideoConfig& config) {
     pImpl->config = config;
     pImpl->frameCount = 0;
+    pImpl->stats = VideoWriterStats();
+    pImpl->resizePool.reset(cv::Size(config.width, config.height), CV_8UC3);
+    pImpl->failed = false;
     
-    if (config.useHardwareEncoding) {
-        // Try GStreamer pipeline for hardware encoding (Jetson)
-        std::string pipeline = getGStreamerPipeline(config);
-        pImpl->writer.open(pipeline, cv::CAP_GSTREAMER, 0, config.fps, 
-                          cv::Size(config.width, config.height), true);
-        
-        if (pImpl->writer.isOpened()) {
-            pImpl->opened = true;
-            std::cout << "[VideoWriter] Opened with GStreamer hardware encoding" << std::endl;
-            return true;
-        }
-        std::cout << "[VideoWriter] GStreamer failed, falling back to FFmpeg" << std::endl;
-    }
-    
-    // Fallback to FFmpeg/software encoding
-    int fourcc = cv::VideoWriter::fourcc(
-        config.codec[0], config.codec[1], config.codec[2], config.codec[3]
-    );
-    
-    pImpl->writer.open(config.outputPath, fourcc, config.fps,
-                       cv::Size(config.width, config.height), true);
-    
-    if (!pImpl->writer.isOpened()) {
-        // Try alternative codecs
-        std::vector<std::string> fallbackCodecs = {"mp4v", "XVID", "MJPG"};
-        for (const auto& codec : fallbackCodecs) {
-            fourcc = cv::VideoWriter::fourcc(codec[0], codec[1], codec[2], codec[3]);
-            pImpl->writer.open(config.outputPath, fourcc, config.fps,
-                              cv::Size(config.width, config.height), true);
-            if (pImpl->writer.isOpened()) {
-                std::cout << "[VideoWriter] Opened with codec: " << codec << std::endl;
-                break;
-            }
-        }
-    }
-    
-    pImpl->opened = pImpl->writer.isOpened();
+    // Encoded container, or raw/Y4M frames for an external encoder
+    pImpl->sink = createFrameSink(config);
+    pImpl->opened = pImpl->sink->open(config);
     
     if (!pImpl->opened) {
         std::cerr << "[VideoWriter] Failed to open video writer" << std::endl;
+    } else if (config.asyncEncoding) {
+        pImpl->startEncodeThread();
     }
     
     return pImpl->opened;
 }
 
 bool VideoWriter::writeFrame(const cv::Mat& frame) {
-    if (!pImpl->opened) return false;
+    return writeFrame(cv::Mat(frame));  // Shares pixel data, no copy
+}
+
+bool VideoWriter::writeFrame(cv::Mat&& frame) {
+    if (!pImpl->opened || pImpl->failed) return false;
     
-    cv::Mat resizedFrame;
-    if (frame.cols != pImpl->config.width || frame.rows != pImpl->config.height) {
-        cv::resize(frame, resizedFrame, cv::Size(pImpl->config.width, pImpl->config.height));
+    if (pImpl->queue) {
+        pImpl->enqueue(QueuedFrame{std::move(frame), 1});
     } else {
-        resizedFrame = frame;
+        pImpl->encode(frame);
     }
     
-    pImpl->writer.write(resizedFrame);
     pImpl->frameCount++;
     return true;
 }
 
+bool VideoWriter::writeHold(const cv::Mat& frame, int count) {
+    if (!pImpl->opened || pImpl->failed || frame.empty()) return false;
+    if (count <= 0) return true;
+    
+    if (pImpl->queue) {
+        pImpl->enqueue(QueuedFrame{frame, count});
+    } else {
+        pImpl->encode(frame, count);
+    }
+    
+    pImpl->frameCount += count;
+    return true;
+}
+
 void VideoWriter::release() {
     if (pImpl->opened) {
-        pImpl->writer.release();
+        pImpl->stopEncodeThread();
+        pImpl->sink->close();
         pImpl->opened = false;
         std::cout << "[VideoWriter] Released. Total frames: " << pImpl->frameCount << std::endl;
+        
+        if (pImpl->config.asyncEncoding) {
+            std::cout << "[VideoWriter] Queue high-water mark: " << pImpl->stats.queueHighWater
+                      << "/" << pImpl->config.queueDepth
+                      << ", render stalled " << pImpl->stats.stallSeconds << " s"
+                      << ", encoding took " << pImpl->stats.encodeSeconds << " s" << std::endl;
+        }
     }
 }
 
@@ -99,6 +183,10 @@ int VideoWriter::getFrameCount() const {
     return pImpl->frameCount;
 }
 
+VideoWriterStats VideoWriter::getStats() const {
+    return pImpl->stats;
+}
+
 std::string VideoWriter::getGStreamerPipeline(const VideoConfig& config) {
     // GStreamer pipeline for Jetson hardware encoding (NVENC)
     std::string pipeline = 
@@ -108,7 +196,9 @@ std::string VideoWriter::getGStreamerPipeline(const VideoConfig& config) {
         "video/x-raw, format=BGRx ! "
         "nvvidconv ! "
         "video/x-raw(memory:NVMM), format=NV12 ! "
-        "nvv4l2h264enc bitrate=8000000 ! "
+        "nvv4l2h264enc bitrate=8000000"
+        " iframeinterval=" + std::to_string(config.keyframeFrames()) +
+        " idrinterval=" + std::to_string(config.keyframeFrames()) + " ! "
         "h264parse ! "
         "mp4mux ! "
         "filesink location=" + config.outputPath;
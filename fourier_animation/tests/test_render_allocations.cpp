@@ -0,0 +1,63 @@
+// AnimationEngine::renderFrame must not allocate once warmed up: after the
+// frame pool holds its buffers, every frame reuses the pooled frames, the
+// path layer and the per-chain position buffers. Counts operator new and
+// cv::Mat buffers with the benchmark's allocation counter. Runs the OpenCV
+// backend with the default stroke widths (circleThickness > 1 draws
+// through cv::circle's EllipseEx, which allocates per circle).
+
+#include "animation.hpp"
+#include "harness.hpp"
+#include "synthetic_shapes.hpp"
+
+#include <cstdio>
+
+namespace {
+
+// Allocations over frames [warmUp, totalFrames) of one configuration
+int64_t steadyStateAllocations(bool showPath, bool dirtyRectangles) {
+    fourier::AnimationConfig config;
+    config.backend = fourier::RenderBackend::OpenCV;
+    config.resolution = cv::Size(1280, 720);
+    config.center = cv::Point2d(640.0, 360.0);
+    config.scale = 720 * 0.37;
+    config.totalFrames = 240;
+    config.numCircles = 100;
+    config.showPath = showPath;
+    config.dirtyRectangles = dirtyRectangles;
+    
+    fourier::AnimationEngine engine;
+    engine.initialize(bench::makeCoefficients(config.numCircles), config);
+    
+    constexpr int kWarmUp = 8;
+    int frame = 0;
+    for (; frame < kWarmUp; ++frame) {
+        engine.renderFrame(frame);
+    }
+    
+    const int64_t before = bench::allocationCount();
+    for (; frame < config.totalFrames; ++frame) {
+        cv::Mat image = engine.renderFrame(frame);
+        if (image.empty()) return -1;
+    }
+    return bench::allocationCount() - before;
+}
+
+} // namespace
+
+int main() {
+    // Installs the counting cv::Mat allocator before any frame exists
+    bench::allocationCount();
+    
+    int failures = 0;
+    for (bool showPath : {false, true}) {
+        for (bool dirty : {false, true}) {
+            int64_t allocations = steadyStateAllocations(showPath, dirty);
+            bool ok = allocations == 0;
+            std::printf("path %d, dirty %d: %lld allocations after warm-up %s\n",
+                        showPath ? 1 : 0, dirty ? 1 : 0, static_cast<long long>(allocations),
+                        ok ? "ok" : "FAILED");
+            failures += ok ? 0 : 1;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}